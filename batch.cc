@@ -0,0 +1,362 @@
+/*
+ * Author: Luke Vandecasteele
+ *
+ * Credits: Matthew Trappert, Dr. Jee W. Choi, Class notes, and other sources
+ *          listed in final report.
+ *
+ * Date Created: 10/16/2026
+ * Last Modified: 10/17/2026
+ *
+ * Description: Final project for CIS 431 at the University of Oregon Fall
+ *              2021. Implementation of the Batch class, which solves a whole
+ *              file of puzzles in one run with one puzzle per thread.
+ * Notes:
+ *       1. See header.h for all class methods and variables.
+ *       2. All methods contain headers for individual usage and description.
+ *       3. Two input formats are accepted, and may be mixed in one file:
+ *          one puzzle per line (e.g. 81 characters for a 9x9, with '.' or
+ *          '0' for empty squares), or the single puzzle format read by
+ *          read_info() repeated, each puzzle starting with its dimension.
+ *          See PuzzleReader for how the file is parsed.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "header.h"
+
+// puzzles solved between writes of the output
+#define BATCH_CHUNK 16384
+// room for one line of a count: any long and the newline
+#define COUNT_WIDTH 21
+
+// Constructor
+Batch::Batch()
+{
+    solved = 0;
+    failed = 0;
+    seconds = 0.0;
+    fixed = 0;
+    counting = 0;
+    limit = 0;
+    convert = 0;
+    pack_file = NULL;
+    cache = NULL;
+}
+
+/*
+ * open()
+ *          Description: Opens the puzzle file, see PuzzleReader.
+ *          Input: file -> path of the puzzle file, "-" for stdin
+ *          Output: returns 1 on success, 0 if it could not be opened
+ *          Calls: PuzzleReader.open()
+ */
+
+int Batch::open(char *file)
+{
+    return reader.open(file);
+}
+
+// lines of numbers for puzzles given as numbers, and packed ones
+// too large for characters
+static int numeric_line(const PuzzleView &view)
+{
+    return view.numeric || (view.packed && view.dim > TOKEN_DIM);
+}
+
+// room for the line of a puzzle: its characters or numbers and the
+// newline, at least the length of a malformed one written back
+static size_t line_width(const PuzzleView &view)
+{
+    if(!view.dim)
+        return view.len + 1;
+    size_t cells = (size_t)view.dim * view.dim;
+    if(!numeric_line(view))
+        return cells + 1;
+    return max(cells * (token_width(view.dim) + 1), view.len + 1);
+}
+
+// writes a solution count as one line, returns 1 if it is unique
+static int count_line(char *out, long found)
+{
+    int n = snprintf(out, COUNT_WIDTH, "%ld", found);
+    out[n] = '\n';
+    return found == 1;
+}
+
+/*
+ * solve_one()
+ *          Description: Solves one puzzle and writes its solution as one
+ *                       line of characters, or of numbers if that is how
+ *                       the puzzle was given. A puzzle that has no solution
+ *                       is written back as it was read, and a malformed
+ *                       one as its first line. When counting, writes the
+ *                       number of solutions found instead. When packing,
+ *                       writes a record, all empty for a malformed puzzle
+ *                       or one of another dimension than the file.
+ *                       Converting writes the puzzle without solving it.
+ *          Input: view -> puzzle from the reader
+ *                 puzzle -> this thread's solver, replaced when the
+ *                           dimension changes
+ *                 out -> where to write the line or record
+ *          Output: returns 1 if the puzzle was solved (or converted), or
+ *                  when counting if its solution is unique, 0 otherwise
+ *          Calls: PuzzleReader.decode(), encode_value(), encode_tokens(),
+ *                 pack_cells(), pack_givens(), Sudoku.solve(),
+ *                 Sudoku.count(), solve_fixed()
+ */
+
+int Batch::solve_one(const PuzzleView &view, Sudoku *&puzzle, char *out)
+{
+    int dim = view.dim;
+    uint8_t *record = (uint8_t *)out;
+    if(!dim && counting)
+        return count_line(out, 0);
+    if(writer.out && dim != writer.header.dim)
+    {
+        memset(record, 0, writer.header.record);
+        return 0;
+    }
+    if(!dim)
+    {
+        memcpy(out, view.data, view.len);
+        out[view.len] = '\n';
+        return 0;
+    }
+
+    int cells = dim * dim;
+    if(puzzle == NULL || puzzle->dim != dim)
+    {
+        retire(puzzle);
+        puzzle = new Sudoku(Board(dim));
+        puzzle->cache = cache;
+    }
+
+    // decode straight from the reader's buffer into the board
+    Board &board = puzzle->board;
+    int valid = reader.decode(view, board.val);
+    if(counting)
+    {
+        long found = 0;
+        if(valid)
+        {
+            board.init_candidates();
+            found = puzzle->count(limit);
+        }
+        return count_line(out, found);
+    }
+
+    // the givens are taken before the board is filled in
+    if(writer.out && !valid)
+    {
+        memset(record, 0, writer.header.record);
+        return 0;
+    }
+    if(writer.out && (writer.header.flags & PACKED_GIVENS))
+        pack_givens(board.val, dim, record);
+
+    int solved = valid;
+    if(valid && !convert)
+    {
+        if(fixed && fixed_supported(dim))
+            solved = solve_fixed(board);
+        else
+        {
+            board.init_candidates();
+            solved = puzzle->solve();
+        }
+    }
+
+    // a puzzle with no solution is decoded again to write it back,
+    // a bad record is written as an empty board
+    if(!solved && valid)
+        reader.decode(view, board.val);
+    else if(!valid && view.packed)
+        memset(board.val, -1, cells);
+
+    if(writer.out)
+        pack_cells(board.val, dim, record);
+    else if(numeric_line(view))
+    {
+        // a malformed line of numbers is copied onto one line
+        size_t n;
+        if(valid || view.packed)
+            n = encode_tokens(board.val, cells, dim, out);
+        else
+        {
+            n = view.len;
+            memcpy(out, view.data, n);
+            replace(out, out + n, '\r', ' ');
+            replace(out, out + n, '\n', ' ');
+        }
+        out[n] = '\n';
+    }
+    else if(solved || view.packed)
+    {
+        for(int c = 0; c < cells; c++)
+            out[c] = encode_value(board.val[c], dim);
+        out[cells] = '\n';
+    }
+    else
+    {
+        for(int r = 0; r < dim; r++)
+            memcpy(out + r * dim, view.data + (size_t)r * view.stride, dim);
+        out[cells] = '\n';
+    }
+    return solved;
+}
+
+/*
+ * retire()
+ *          Description: Adds the tactic and search counters of a thread's
+ *                       solver to the totals and deletes it.
+ *          Input: puzzle -> solver to delete, may be NULL
+ *          Output: None
+ *          Calls: Propagator.merge()
+ */
+
+void Batch::retire(Sudoku *puzzle)
+{
+    if(puzzle == NULL)
+        return;
+    #pragma omp critical(batch_tactics)
+    {
+        totals.merge(puzzle->engine);
+        stats.merge(puzzle->stats);
+    }
+    delete puzzle;
+}
+
+/*
+ * solve()
+ *          Description: Solves every puzzle in the file, one puzzle per
+ *                       thread at a time, and writes one line per puzzle in
+ *                       input order, or one record per puzzle to pack_file.
+ *                       The packed file takes the dimension of the first
+ *                       valid puzzle. Puzzles are handled in chunks so
+ *                       memory stays small however large the file is. Time
+ *                       is charged to the parse, search, and output
+ *                       phases.
+ *          Input: out -> where to write the solutions
+ *          Output: returns 0 if pack_file could not be created, 1 otherwise
+ *          Calls: PuzzleReader.next(), solve_one(), PackedWriter methods,
+ *                 ScopedTimer.next()
+ */
+
+int Batch::solve(FILE *out)
+{
+    vector<char> buffer;
+    uint64_t start = ReadClock();
+    ScopedTimer timer(PHASE_PARSE);
+
+    for(;;)
+    {
+        // gather a chunk of puzzles
+        timer.next(PHASE_PARSE);
+        views.clear();
+        lines.clear();
+        PuzzleView view;
+        while(views.size() < BATCH_CHUNK && reader.next(view))
+            views.push_back(view);
+        if(views.empty())
+            break;
+
+        if(pack_file && !counting && !writer.out)
+        {
+            int dim = 0;
+            for(unsigned int i = 0; i < views.size() && !dim; i++)
+                dim = views[i].dim;
+            if(dim && !writer.create(pack_file, dim,
+                                     convert ? 0 : PACKED_GIVENS))
+                return 0;
+        }
+
+        // lay out their output lines or records
+        size_t total = 0;
+        int ragged = counting;
+        for(unsigned int i = 0; i < views.size(); i++)
+        {
+            lines.push_back(total);
+            if(counting)
+                total += COUNT_WIDTH;
+            else if(writer.out)
+                total += writer.header.record;
+            else
+                total += line_width(views[i]);
+            ragged |= views[i].numeric;
+        }
+        buffer.resize(total);
+
+        long count = 0;
+        long n = views.size();
+        timer.next(PHASE_SEARCH);
+        #pragma omp parallel reduction(+:count)
+        {
+            Sudoku *puzzle = NULL;
+
+            #pragma omp for schedule(dynamic, 64)
+            for(long i = 0; i < n; i++)
+                count += solve_one(views[i], puzzle, &buffer[lines[i]]);
+
+            retire(puzzle);
+        }
+
+        solved += count;
+        failed += n - count;
+        timer.next(PHASE_OUTPUT);
+        if(writer.out)
+            writer.write((const uint8_t *)buffer.data(), n);
+        else if(ragged)
+        {
+            // counts and numbers can be shorter than their slots
+            for(long i = 0; i < n; i++)
+            {
+                const char *line = &buffer[lines[i]];
+                fwrite(line, 1, strchr(line, '\n') - line + 1, out);
+            }
+        }
+        else if(!pack_file || counting)
+            fwrite(buffer.data(), 1, total, out);
+
+        // the chunk's views are done with
+        reader.release();
+    }
+    writer.close();
+    fflush(out);
+    seconds = ElapsedTime(ReadClock() - start);
+    return 1;
+}
+
+/*
+ * summary()
+ *          Description: Prints how many puzzles were solved, or found to be
+ *                       unique when counting up to 2, and how many puzzles
+ *                       were worked on per second.
+ *          Input: out -> where to print the summary
+ *          Output: None
+ *          Calls: None
+ */
+
+void Batch::summary(FILE *out)
+{
+    long total = solved + failed;
+    if(counting && limit == 2)
+        fprintf(out, "Puzzles: %ld unique: %ld not unique: %ld\n",
+                total, solved, failed);
+    else if(counting)
+        fprintf(out, "Puzzles: %ld\n", total);
+    else if(convert)
+        fprintf(out, "Puzzles: %ld converted: %ld failed: %ld\n",
+                total, solved, failed);
+    else
+        fprintf(out, "Puzzles: %ld solved: %ld failed: %ld\n",
+                total, solved, failed);
+    // every puzzle is worked on, counted or not
+    fprintf(out, "Time to solve: %g threads: %d puzzles/sec: %.1f\n",
+            seconds, omp_get_max_threads(),
+            seconds > 0.0 ? total / seconds : 0.0);
+    if(totals.tactics)
+        totals.report(out);
+    if(cache)
+        cache->report(out);
+}
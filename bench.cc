@@ -0,0 +1,366 @@
+/*
+ * Author: Luke Vandecasteele
+ *
+ * Credits: Matthew Trappert, Dr. Jee W. Choi, Class notes, and other sources
+ *          listed in final report.
+ *
+ * Date Created: 10/16/2026
+ * Last Modified: 10/17/2026
+ *
+ * Description: Final project for CIS 431 at the University of Oregon Fall
+ *              2021. Benchmark driver, built as sdkbench by "make bench".
+ *              Runs the solving engines over files of puzzles, sweeping the
+ *              number of threads, and reports the solve times as CSV or
+ *              JSON.
+ * Notes:
+ *       1. Usage: sdkbench [-r REPS] [-t THREADS] [-e ENGINES] [-j] FILE...
+ *          -r  times every puzzle is solved per configuration (default 3)
+ *          -t  most threads to sweep to (default every core), the sweep is
+ *              1, 2, 4, ... and then the maximum
+ *          -e  comma separated engines: serial, parallel, tasks, fixed,
+ *              dlx (default serial,parallel). Only parallel and tasks are
+ *              swept, the others are single threaded and run once with 1
+ *              thread.
+ *          -j  print JSON instead of CSV
+ *       2. Speedup is against the same engine with 1 thread, and vs_serial
+ *          against the serial engine on the same corpus. Efficiency is
+ *          speedup divided by threads.
+ *       3. Puzzle files are read with PuzzleReader, so any format the
+ *          solver reads works. The corpus in puzzles/ has one file per size
+ *          and difficulty.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "header.h"
+
+// one line of the report
+struct Result
+{
+    string corpus;
+    string engine;
+    int threads;
+    int puzzles;
+    int runs;
+    int solved;
+    double median;
+    double p90;
+    double p99;
+    double total;
+    double speedup;
+    double efficiency;
+    double vs_serial;
+};
+
+/* Functions */
+void usage(char *argv);
+int load(const char *file, vector<Board> &boards);
+double solve_once(const string &engine, const Board &board, int &solved);
+double percentile(const vector<double> &sorted, double p);
+void print_csv(const Result &r);
+void print_json(const vector<Result> &results);
+
+int main(int argc, char **argv)
+{
+    int reps = 3;
+    int max_threads = omp_get_num_procs();
+    string engines = "serial,parallel";
+    int json = 0;
+
+    int flag;
+    opterr = 0;
+    while((flag = getopt(argc, argv, "r:t:e:j")) != -1)
+    {
+        switch(flag)
+        {
+            case 'r':
+                reps = atoi(optarg);
+                break;
+
+            case 't':
+                max_threads = atoi(optarg);
+                break;
+
+            case 'e':
+                engines = optarg;
+                break;
+
+            case 'j':
+                json = 1;
+                break;
+
+            case '?':
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    if(optind >= argc || reps < 1 || max_threads < 1)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // engines to run, in the order given
+    vector<string> names;
+    size_t start = 0;
+    while(start <= engines.size())
+    {
+        size_t end = engines.find(',', start);
+        if(end == string::npos)
+            end = engines.size();
+        string name = engines.substr(start, end - start);
+        start = end + 1;
+        if(name != "serial" && name != "parallel" && name != "tasks" &&
+           name != "fixed" && name != "dlx")
+        {
+            fprintf(stderr, "Unknown engine %s\n", name.c_str());
+            return 1;
+        }
+        names.push_back(name);
+    }
+
+    // thread counts for the parallel engines
+    vector<int> sweep;
+    for(int t = 1; t < max_threads; t *= 2)
+        sweep.push_back(t);
+    sweep.push_back(max_threads);
+
+    if(!json)
+        printf("corpus,engine,threads,puzzles,runs,solved,median_ms,p90_ms,"
+               "p99_ms,solves_per_sec,speedup,efficiency,vs_serial\n");
+
+    vector<Result> results;
+    for(int f = optind; f < argc; f++)
+    {
+        vector<Board> boards;
+        if(!load(argv[f], boards))
+        {
+            fprintf(stderr, "Could not read %s\n", argv[f]);
+            continue;
+        }
+
+        // name the corpus after the file, without directory or extension
+        string corpus = argv[f];
+        corpus = corpus.substr(corpus.find_last_of('/') + 1);
+        corpus = corpus.substr(0, corpus.find_last_of('.'));
+
+        double serial_total = 0.0;
+        for(unsigned int e = 0; e < names.size(); e++)
+        {
+            const string &engine = names[e];
+            double single_total = 0.0;
+
+            for(unsigned int s = 0; s < sweep.size(); s++)
+            {
+                int threads = sweep[s];
+                if(engine != "parallel" && engine != "tasks" && threads > 1)
+                    break;
+                omp_set_num_threads(threads);
+                fprintf(stderr, "%s %s %d threads\n", corpus.c_str(),
+                        engine.c_str(), threads);
+
+                // warm up tables and thread pools
+                int solved;
+                solve_once(engine, boards[0], solved);
+
+                Result r;
+                vector<double> times;
+                r.solved = 0;
+                r.total = 0.0;
+                for(int rep = 0; rep < reps; rep++)
+                {
+                    for(unsigned int i = 0; i < boards.size(); i++)
+                    {
+                        double t = solve_once(engine, boards[i], solved);
+                        times.push_back(t);
+                        r.total += t;
+                        r.solved += solved;
+                    }
+                }
+                sort(times.begin(), times.end());
+
+                if(threads == 1)
+                    single_total = r.total;
+                if(engine == "serial")
+                    serial_total = r.total;
+
+                r.corpus = corpus;
+                r.engine = engine;
+                r.threads = threads;
+                r.puzzles = boards.size();
+                r.runs = times.size();
+                r.median = percentile(times, 0.5);
+                r.p90 = percentile(times, 0.9);
+                r.p99 = percentile(times, 0.99);
+                r.speedup = r.total > 0.0 ? single_total / r.total : 0.0;
+                r.efficiency = r.speedup / threads;
+                r.vs_serial = serial_total > 0.0 && r.total > 0.0 ?
+                              serial_total / r.total : 0.0;
+                results.push_back(r);
+
+                if(!json)
+                {
+                    print_csv(r);
+                    fflush(stdout);
+                }
+            }
+        }
+    }
+
+    if(json)
+        print_json(results);
+    return 0;
+}
+
+void usage(char *argv)
+{
+    fprintf(stderr, "Usage: %s [-r REPS] [-t THREADS] [-e ENGINES] [-j]"
+            " FILE...\n", argv);
+    fprintf(stderr, "  -r  times each puzzle is solved (default 3)\n");
+    fprintf(stderr, "  -t  most threads to sweep to (default all cores)\n");
+    fprintf(stderr, "  -e  engines from serial,parallel,tasks,fixed,dlx"
+            " (default serial,parallel)\n");
+    fprintf(stderr, "  -j  print JSON instead of CSV\n");
+}
+
+/*
+ * load()
+ *          Description: Reads every puzzle in a file, skipping malformed
+ *                       ones.
+ *          Input: file -> puzzle file
+ *                 boards -> the puzzles are appended here
+ *          Output: returns the number of puzzles read
+ *          Calls: PuzzleReader methods
+ */
+
+int load(const char *file, vector<Board> &boards)
+{
+    PuzzleReader reader;
+    PuzzleView view;
+    if(!reader.open(file))
+        return 0;
+
+    while(reader.next(view))
+    {
+        if(!view.dim)
+            continue;
+        Board board(view.dim);
+        if(!reader.decode(view, board.val))
+            continue;
+        board.init_candidates();
+        boards.push_back(std::move(board));
+    }
+    return boards.size();
+}
+
+/*
+ * solve_once()
+ *          Description: Solves one copy of a puzzle with an engine. Only the
+ *                       solve itself is timed, not setting up the engine.
+ *          Input: engine -> serial, parallel, tasks, fixed, or dlx
+ *                 board -> puzzle to solve
+ *                 solved -> set to 1 if the puzzle was solved
+ *          Output: seconds taken
+ *          Calls: solve() of the engine
+ */
+
+double solve_once(const string &engine, const Board &board, int &solved)
+{
+    double start;
+    double end;
+
+    if(engine == "serial")
+    {
+        Sudoku puzzle(board);
+        start = omp_get_wtime();
+        solved = puzzle.solve();
+        end = omp_get_wtime();
+    }
+    else if(engine == "parallel")
+    {
+        Parallel puzzle(board);
+
+        // solve() reports its progress on cout
+        streambuf *progress = cout.rdbuf(NULL);
+        start = omp_get_wtime();
+        puzzle.solve();
+        end = omp_get_wtime();
+        cout.rdbuf(progress);
+        cout.clear();
+
+        int status;
+        solved = puzzle.is_complete() && puzzle.is_valid(status);
+    }
+    else if(engine == "tasks")
+    {
+        TaskSearch puzzle(board);
+        start = omp_get_wtime();
+        solved = puzzle.solve();
+        end = omp_get_wtime();
+    }
+    else if(engine == "fixed")
+    {
+        Board copy(board);
+        start = omp_get_wtime();
+        solved = fixed_supported(copy.dim) && solve_fixed(copy);
+        end = omp_get_wtime();
+    }
+    else
+    {
+        DLX puzzle(board);
+        start = omp_get_wtime();
+        solved = puzzle.solve(1) > 0;
+        end = omp_get_wtime();
+    }
+    return end - start;
+}
+
+/*
+ * percentile()
+ *          Description: Nearest rank percentile of sorted times.
+ *          Input: sorted -> times in increasing order
+ *                 p -> fraction, e.g. 0.9
+ *          Output: the percentile in milliseconds
+ *          Calls: None
+ */
+
+double percentile(const vector<double> &sorted, double p)
+{
+    if(sorted.empty())
+        return 0.0;
+    size_t rank = (size_t)ceil(p * sorted.size());
+    if(rank < 1)
+        rank = 1;
+    return sorted[rank - 1] * 1000.0;
+}
+
+void print_csv(const Result &r)
+{
+    printf("%s,%s,%d,%d,%d,%d,%.4f,%.4f,%.4f,%.1f,%.3f,%.3f,%.3f\n",
+           r.corpus.c_str(), r.engine.c_str(), r.threads, r.puzzles, r.runs,
+           r.solved, r.median, r.p90, r.p99,
+           r.total > 0.0 ? r.runs / r.total : 0.0,
+           r.speedup, r.efficiency, r.vs_serial);
+}
+
+void print_json(const vector<Result> &results)
+{
+    printf("[\n");
+    for(unsigned int i = 0; i < results.size(); i++)
+    {
+        const Result &r = results[i];
+        printf("  {\"corpus\": \"%s\", \"engine\": \"%s\", \"threads\": %d, "
+               "\"puzzles\": %d, \"runs\": %d, \"solved\": %d, "
+               "\"median_ms\": %.4f, \"p90_ms\": %.4f, \"p99_ms\": %.4f, "
+               "\"solves_per_sec\": %.1f, \"speedup\": %.3f, "
+               "\"efficiency\": %.3f, \"vs_serial\": %.3f}%s\n",
+               r.corpus.c_str(), r.engine.c_str(), r.threads, r.puzzles,
+               r.runs, r.solved, r.median, r.p90, r.p99,
+               r.total > 0.0 ? r.runs / r.total : 0.0,
+               r.speedup, r.efficiency, r.vs_serial,
+               i + 1 < results.size() ? "," : "");
+    }
+    printf("]\n");
+}
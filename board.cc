@@ -0,0 +1,464 @@
+/*
+ * Author: Luke Vandecasteele
+ *
+ * Credits: Matthew Trappert, Dr. Jee W. Choi, Class notes, and other sources
+ *          listed in final report.
+ *
+ * Date Created: 10/16/2026
+ * Last Modified: 10/17/2026
+ *
+ * Description: Final project for CIS 431 at the University of Oregon Fall
+ *              2021. Implementation of the Layout and Board classes that
+ *              store the state of a puzzle in flat, contiguous memory.
+ * Notes:
+ *       1. See header.h for all class methods and variables.
+ *       2. All methods contain headers for individual usage and description.
+ *
+ */
+
+#include <string.h>
+#include "header.h"
+
+#define CACHE_LINE 64
+
+// rounds a byte count up to a whole number of cache lines
+static size_t line_round(size_t bytes)
+{
+    return (bytes + CACHE_LINE - 1) & ~(size_t)(CACHE_LINE - 1);
+}
+
+// Constructor
+Layout::Layout(int n)
+{
+    dim = n;
+    nonet = sqrt(n);
+    cells = n * n;
+    num_groups = 3 * n;
+
+    groups.resize(num_groups * dim);
+    cell_groups.resize(cells * 3);
+
+    for(int i = 0; i < dim; i++)
+    {
+        // offset of the top left cell of nonet i
+        int row = (i / nonet) * nonet;
+        int col = (i % nonet) * nonet;
+
+        for(int k = 0; k < dim; k++)
+        {
+            groups[(3 * i) * dim + k] = i * dim + k;
+            groups[(3 * i + 1) * dim + k] = k * dim + i;
+            groups[(3 * i + 2) * dim + k] =
+                (row + k / nonet) * dim + col + k % nonet;
+        }
+    }
+
+    // reverse map from a cell to the three groups it belongs to
+    for(int g = 0; g < num_groups; g++)
+    {
+        for(int k = 0; k < dim; k++)
+            cell_groups[groups[g * dim + k] * 3 + g % 3] = g;
+    }
+}
+
+/*
+ * get()
+ *          Description: Returns the shared Layout for a dimension, building
+ *                       it the first time it is asked for.
+ *          Input: n -> dimension of the puzzle
+ *          Output: a Layout pointer that lives for the rest of the program
+ *          Calls: Layout()
+ */
+
+const Layout* Layout::get(int n)
+{
+    static vector<Layout*> layouts;
+    const Layout *layout = NULL;
+
+    #pragma omp critical(layout_get)
+    {
+        if((int)layouts.size() <= n)
+            layouts.resize(n + 1, NULL);
+        if(layouts[n] == NULL)
+            layouts[n] = new Layout(n);
+        layout = layouts[n];
+    }
+    return layout;
+}
+
+// default constructor
+Board::Board()
+{
+    layout = NULL;
+    dim = 0;
+    cells = 0;
+    bytes = 0;
+    data = NULL;
+    cand = NULL;
+    used = NULL;
+    val = NULL;
+    trail = NULL;
+}
+
+// constructor, every cell starts empty
+Board::Board(int n)
+{
+    trail = NULL;
+    allocate(Layout::get(n));
+    memset(data, 0, bytes);
+    memset(val, -1, cells);
+}
+
+// copy constructor
+Board::Board(const Board &other)
+{
+    data = NULL;
+    trail = NULL;
+    if(other.data == NULL)
+    {
+        layout = NULL;
+        dim = cells = 0;
+        bytes = 0;
+        cand = used = NULL;
+        val = NULL;
+        return;
+    }
+    allocate(other.layout);
+    memcpy(data, other.data, bytes);
+}
+
+// move constructor
+Board::Board(Board &&other)
+{
+    trail = NULL;
+    layout = other.layout;
+    dim = other.dim;
+    cells = other.cells;
+    bytes = other.bytes;
+    data = other.data;
+    cand = other.cand;
+    used = other.used;
+    val = other.val;
+    other.data = NULL;
+}
+
+// destructor
+Board::~Board()
+{
+    release();
+}
+
+Board& Board::operator=(const Board &other)
+{
+    if(this == &other)
+        return *this;
+    if(other.data == NULL)
+    {
+        release();
+        return *this;
+    }
+    if(data == NULL || dim != other.dim)
+    {
+        release();
+        allocate(other.layout);
+    }
+    memcpy(data, other.data, bytes);
+    return *this;
+}
+
+Board& Board::operator=(Board &&other)
+{
+    if(this != &other)
+    {
+        release();
+        layout = other.layout;
+        dim = other.dim;
+        cells = other.cells;
+        bytes = other.bytes;
+        data = other.data;
+        cand = other.cand;
+        used = other.used;
+        val = other.val;
+        other.data = NULL;
+    }
+    return *this;
+}
+
+/*
+ * allocate()
+ *          Description: Allocates one aligned buffer for a board of the given
+ *                       dimension and points the cand, used, and val arrays
+ *                       into it, each starting on its own cache line.
+ *          Input: l -> shared index tables for the dimension
+ *          Output: None
+ *          Calls: None
+ */
+
+void Board::allocate(const Layout *l)
+{
+    layout = l;
+    dim = l->dim;
+    cells = l->cells;
+
+    size_t cand_bytes = line_round(cells * sizeof(mask_t));
+    size_t used_bytes = line_round(layout->num_groups * sizeof(mask_t));
+    size_t val_bytes = line_round(cells * sizeof(int8_t));
+    bytes = cand_bytes + used_bytes + val_bytes;
+
+    void *buf = NULL;
+    if(posix_memalign(&buf, CACHE_LINE, bytes) != 0)
+        throw bad_alloc();
+    data = (char *)buf;
+
+    cand = (mask_t *)data;
+    used = (mask_t *)(data + cand_bytes);
+    val = (int8_t *)(data + cand_bytes + used_bytes);
+}
+
+void Board::release()
+{
+    free(data);
+    data = NULL;
+}
+
+/*
+ * init_candidates()
+ *          Description: Called once a puzzle has been read. Computes the
+ *                       used values of every group, and gives every empty
+ *                       cell all values not used by its row, col, or nonet.
+ *          Input: None
+ *          Output: None
+ *          Calls: None
+ */
+
+void Board::init_candidates()
+{
+    for(int g = 0; g < layout->num_groups; g++)
+    {
+        const int *group = layout->group(g);
+        used[g] = 0;
+        for(int k = 0; k < dim; k++)
+        {
+            if(val[group[k]] != -1)
+                used[g] |= mask_bit(val[group[k]]);
+        }
+    }
+
+    mask_t choices = mask_all(dim);
+    for(int c = 0; c < cells; c++)
+    {
+        if(val[c] != -1)
+        {
+            cand[c] = 0;
+            continue;
+        }
+        const int *g = layout->groups_of(c);
+        cand[c] = choices & ~(used[g[0]] | used[g[1]] | used[g[2]]);
+    }
+}
+
+/*
+ * assign()
+ *          Description: Places a value into a cell, clearing the cell's
+ *                       candidates and marking the value as used in each of
+ *                       its groups.
+ *          Input: c -> cell index
+ *                 v -> value to place
+ *          Output: None
+ *          Calls: None
+ */
+
+void Board::assign(int c, int v)
+{
+    mask_t bit = mask_bit(v);
+    const int *g = layout->groups_of(c);
+
+    if(trail)
+    {
+        int groups = layout->num_groups;
+        trail->record(cells + groups + c, (mask_t)val[c]);
+        trail->record(c, cand[c]);
+        trail->record(cells + g[0], used[g[0]]);
+        trail->record(cells + g[1], used[g[1]]);
+        trail->record(cells + g[2], used[g[2]]);
+    }
+
+    val[c] = v;
+    cand[c] = 0;
+    used[g[0]] |= bit;
+    used[g[1]] |= bit;
+    used[g[2]] |= bit;
+}
+
+/*
+ * save()
+ *          Description: Copies the board's state into a block of bytes.
+ *          Input: block -> at least bytes long
+ *          Output: None
+ *          Calls: None
+ */
+
+void Board::save(char *block) const
+{
+    memcpy(block, data, bytes);
+}
+
+/*
+ * load()
+ *          Description: Restores a state written by save() on a board of the
+ *                       same dimension.
+ *          Input: block -> state from save()
+ *          Output: None
+ *          Calls: None
+ */
+
+void Board::load(const char *block)
+{
+    memcpy(data, block, bytes);
+}
+
+/*
+ * undo()
+ *          Description: Rolls a board back to the state it had when the
+ *                       marker was taken, restoring entries newest first.
+ *          Input: board -> board the trail was recorded on
+ *                 marker -> value returned by mark()
+ *          Output: None
+ *          Calls: None
+ */
+
+void Trail::undo(Board &board, size_t marker)
+{
+    int cells = board.cells;
+    int groups = board.layout->num_groups;
+
+    while(entries.size() > marker)
+    {
+        const Entry &e = entries.back();
+        if(e.slot < cells)
+            board.cand[e.slot] = e.old;
+        else if(e.slot < cells + groups)
+            board.used[e.slot - cells] = e.old;
+        else
+            board.val[e.slot - cells - groups] = (int8_t)e.old;
+        entries.pop_back();
+    }
+}
+
+/*
+ * decode_value()
+ *          Description: Converts a character from a puzzle file to a value.
+ *                       9x9 puzzles use the digits 1-9, 16x16 puzzles use
+ *                       the hex digits 0-f for 1-16, and larger puzzles use
+ *                       the letters a, b, c, ... for 1, 2, 3, ...
+ *                       '.' marks an empty square, as does '0' in 9x9 and
+ *                       smaller puzzles.
+ *          Input: ch -> character from the file
+ *                 dim -> dimension of the puzzle
+ *          Output: the value, -1 for an empty square, or 0 if the character
+ *                  is not valid for this dimension
+ *          Calls: None
+ */
+
+int decode_value(char ch, int dim)
+{
+    // tolower() is only defined for unsigned char values and EOF
+    int num = tolower((unsigned char)ch);
+    int val;
+
+    if(num == '.')
+        return -1;
+    if(dim > 16)
+        val = num - 96;
+    else if(dim == 16)
+    {
+        if(num > 96)
+            val = num - 86;
+        else
+            val = num - 47;
+    }
+    else
+    {
+        val = num - '0';
+        if(val == 0)
+            return -1;
+    }
+
+    if(val < 1 || val > dim)
+        return 0;
+    return val;
+}
+
+/*
+ * encode_value()
+ *          Description: Converts a value to the character used for it in
+ *                       puzzle files, the inverse of decode_value().
+ *          Input: val -> value, -1 for an empty square
+ *                 dim -> dimension of the puzzle
+ *          Output: a character
+ *          Calls: None
+ */
+
+char encode_value(int val, int dim)
+{
+    if(val == -1)
+        return '.';
+    if(dim > 16)
+        return (char)(val + 96);
+    if(dim == 16)
+        return "0123456789abcdef"[val - 1];
+    return (char)('0' + val);
+}
+
+/*
+ * token_width()
+ *          Description: Number of digits in the largest value of a puzzle,
+ *                       the width every number is written with.
+ *          Input: dim -> dimension of the puzzle
+ *          Output: the width
+ *          Calls: None
+ */
+
+int token_width(int dim)
+{
+    int width = 1;
+    for(int n = dim; n >= 10; n /= 10)
+        width++;
+    return width;
+}
+
+/*
+ * encode_tokens()
+ *          Description: Writes values as numbers separated by spaces, with 0
+ *                       for an empty square. Every number is right aligned
+ *                       to token_width() so the length of a line only
+ *                       depends on the dimension.
+ *          Input: val -> values to write, -1 for an empty square
+ *                 n -> number of values
+ *                 dim -> dimension of the puzzle
+ *                 out -> where to write, room for n * (token_width() + 1)
+ *          Output: number of characters written, no space after the last
+ *          Calls: token_width()
+ */
+
+size_t encode_tokens(const int8_t *val, int n, int dim, char *out)
+{
+    int width = token_width(dim);
+    char *p = out;
+    for(int i = 0; i < n; i++)
+    {
+        int v = val[i] == -1 ? 0 : val[i];
+        int k = width - 1;
+        do
+        {
+            p[k--] = (char)('0' + v % 10);
+            v /= 10;
+        } while(v);
+        while(k >= 0)
+            p[k--] = ' ';
+        p += width;
+        if(i + 1 < n)
+            *p++ = ' ';
+    }
+    return p - out;
+}
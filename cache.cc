@@ -0,0 +1,548 @@
+/*
+ * Author: Luke Vandecasteele
+ *
+ * Credits: Matthew Trappert, Dr. Jee W. Choi, Class notes, and other sources
+ *          listed in final report.
+ *
+ * Date Created: 10/17/2026
+ * Last Modified: 10/17/2026
+ *
+ * Description: Final project for CIS 431 at the University of Oregon Fall
+ *              2021. Implementation of the SolveCache class, a cache of
+ *              solutions shared by every thread, and of canonical_form(),
+ *              which gives every puzzle of a symmetry class the same key.
+ * Notes:
+ *       1. See header.h for all class methods and variables.
+ *       2. All methods contain headers for individual usage and description.
+ *       3. The symmetries are the transpose, the order of the bands and of
+ *          the rows inside each band, the same for stacks and cols, and the
+ *          relabeling of digits. The canonical form is the least puzzle
+ *          they can make, read row by row with digits numbered in the order
+ *          they first appear and empty squares after every digit.
+ *       4. To cut down the ties, rows come first by how many givens they
+ *          hold, bands by the counts of their rows, and the same for cols
+ *          and stacks. Only the orders that keep those counts sorted are
+ *          searched, and only the sides (transposed or not) whose counts
+ *          sort first. Since the counts can be read off the form, the form
+ *          is still the same for the whole class.
+ *       5. The least form is found depth first: the first row and the col
+ *          order square by square, then one whole row at a time, leaving a
+ *          branch as soon as it reads larger than the best so far. Puzzles
+ *          with many ties can take long, the search gives up after a number
+ *          of steps and the puzzle is solved without the cache.
+ *       6. The cache is split in shards, each an LRU list behind its own
+ *          lock, so threads rarely wait on each other.
+ *
+ */
+
+#include <string.h>
+#include <list>
+#include <unordered_map>
+#include "header.h"
+
+// shards of the cache, each with its own lock
+#define CACHE_SHARDS 16
+// steps canonical_form() may take for a puzzle from the solver
+#define CANON_LIMIT 20000
+
+// one shard: entries from most to least recently used, and their index
+struct SolveCache::Shard
+{
+    mutex lock;
+    // entries this shard may hold
+    size_t limit;
+    list< pair<string, string> > order;
+    unordered_map< string, list< pair<string, string> >::iterator > index;
+};
+
+/*
+ * Canonizer is the depth first search of canonical_form(). out holds the
+ * puzzle being built, best the least one finished so far, and both use
+ * dim + 1 for an empty square so that digits sort first. best starts out
+ * larger than any form.
+ */
+struct Canonizer
+{
+    const int8_t *val;
+    int dim;
+    int nonet;
+    int transpose;
+    long steps;
+    long limit;
+
+    // row (col) of the puzzle at each row (col) of the form, the band
+    // (stack) used for each band (stack) of the form, and what is taken
+    vector<int> rows;
+    vector<int> cols;
+    vector<int> bands;
+    vector<int> stacks;
+    vector<char> row_used;
+    vector<char> col_used;
+    vector<char> band_used;
+    vector<char> stack_used;
+
+    // givens in each row (col) of the puzzle, and the count each row
+    // (col) of the form must have
+    vector<int> row_count;
+    vector<int> col_count;
+    vector<int> row_profile;
+    vector<int> col_profile;
+
+    // label of each digit, 0 until it appears, and the digits labeled in
+    // order so they can be taken back
+    vector<int> labels;
+    vector<int> labeled;
+
+    vector<int> out;
+    vector<int> best;
+    // forms kept so far, see first_row()
+    long kept;
+    Symmetry found;
+
+    Canonizer(const int8_t *v, int n, long l);
+    int at(int r, int c);
+    void profile(vector<int> &counts, vector<int> &order, int by_rows);
+    int label(int v);
+    void unlabel(size_t mark);
+    int first_row(int j, int less);
+    int next_row(int i, int less);
+    void keep();
+};
+
+Canonizer::Canonizer(const int8_t *v, int n, long l)
+    : rows(n), cols(n), bands(n), stacks(n), row_used(n), col_used(n),
+      band_used(n), stack_used(n), row_count(n), col_count(n),
+      labels(n + 1), out(n * n),
+      best(n * n, n + 2)
+{
+    val = v;
+    dim = n;
+    nonet = (int)(sqrt((double)n) + 0.5);
+    transpose = 0;
+    steps = 0;
+    limit = l;
+    kept = 0;
+}
+
+// value at a row and col of the puzzle, after the transpose
+int Canonizer::at(int r, int c)
+{
+    return transpose ? val[c * dim + r] : val[r * dim + c];
+}
+
+/*
+ * profile()
+ *          Description: Counts the givens in every row (or col) of the
+ *                       puzzle, and the counts in the order the form must
+ *                       have them: most first inside each band, and bands
+ *                       with the most first.
+ *          Input: counts -> filled in with the count of each row
+ *                 order -> filled in with the count at each row of the form
+ *                 by_rows -> 1 for rows and bands, 0 for cols and stacks
+ *          Output: None
+ *          Calls: at()
+ */
+
+void Canonizer::profile(vector<int> &counts, vector<int> &order, int by_rows)
+{
+    for(int r = 0; r < dim; r++)
+    {
+        counts[r] = 0;
+        for(int c = 0; c < dim; c++)
+            counts[r] += (by_rows ? at(r, c) : at(c, r)) != -1;
+    }
+
+    vector< vector<int> > bands(nonet);
+    for(int b = 0; b < nonet; b++)
+    {
+        bands[b].assign(counts.begin() + b * nonet,
+                        counts.begin() + (b + 1) * nonet);
+        sort(bands[b].rbegin(), bands[b].rend());
+    }
+    sort(bands.rbegin(), bands.rend());
+
+    order.clear();
+    for(int b = 0; b < nonet; b++)
+        order.insert(order.end(), bands[b].begin(), bands[b].end());
+}
+
+// label of a value, numbering digits as they first appear
+int Canonizer::label(int v)
+{
+    if(v == -1)
+        return dim + 1;
+    if(!labels[v])
+    {
+        labeled.push_back(v);
+        labels[v] = labeled.size();
+    }
+    return labels[v];
+}
+
+// takes back the labels given since mark
+void Canonizer::unlabel(size_t mark)
+{
+    while(labeled.size() > mark)
+    {
+        labels[labeled.back()] = 0;
+        labeled.pop_back();
+    }
+}
+
+// the current form is the least so far
+void Canonizer::keep()
+{
+    best = out;
+    kept++;
+    found.transpose = transpose;
+    found.rows = rows;
+    found.cols = cols;
+}
+
+/*
+ * first_row()
+ *          Description: Picks the col for square j of the first row, and
+ *                       the ones after it, then goes on to the other rows.
+ *                       A col starting a stack picks the stack.
+ *          Input: j -> col of the form to fill
+ *                 less -> 1 if the form already reads less than best
+ *          Output: returns 0 if the search ran out of steps, 1 otherwise
+ *          Calls: label(), unlabel(), next_row()
+ */
+
+int Canonizer::first_row(int j, int less)
+{
+    if(j == dim)
+        return next_row(1, less);
+
+    // a form kept below has the same prefix as this one, so the rest
+    // have to be less than it again
+    int s = j / nonet;
+    long seen = kept;
+    for(int c = 0; c < dim; c++)
+    {
+        int stack = c / nonet;
+        if(kept != seen)
+            less = 0;
+        if(col_used[c] || col_count[c] != col_profile[j])
+            continue;
+        if(j % nonet == 0 ? stack_used[stack] : stack != stacks[s])
+            continue;
+        if(++steps > limit)
+            return 0;
+
+        size_t mark = labeled.size();
+        int v = label(at(rows[0], c));
+        if(less || v <= best[j])
+        {
+            out[j] = v;
+            cols[j] = c;
+            col_used[c] = 1;
+            if(j % nonet == 0)
+            {
+                stacks[s] = stack;
+                stack_used[stack] = 1;
+            }
+            int ok = first_row(j + 1, less || v < best[j]);
+            col_used[c] = 0;
+            if(j % nonet == 0)
+                stack_used[stack] = 0;
+            if(!ok)
+                return 0;
+        }
+        unlabel(mark);
+    }
+    return 1;
+}
+
+/*
+ * next_row()
+ *          Description: Picks row i of the form, and the ones after it, now
+ *                       that the cols are fixed. A row starting a band
+ *                       picks the band. A finished form that reads less
+ *                       than best replaces it.
+ *          Input: i -> row of the form to fill
+ *                 less -> 1 if the form already reads less than best
+ *          Output: returns 0 if the search ran out of steps, 1 otherwise
+ *          Calls: label(), unlabel(), keep()
+ */
+
+int Canonizer::next_row(int i, int less)
+{
+    if(i == dim)
+    {
+        if(less)
+            keep();
+        return 1;
+    }
+
+    int b = i / nonet;
+    long seen = kept;
+    for(int r = 0; r < dim; r++)
+    {
+        int band = r / nonet;
+        if(kept != seen)
+            less = 0;
+        if(row_used[r] || row_count[r] != row_profile[i])
+            continue;
+        if(i % nonet == 0 ? band_used[band] : band != bands[b])
+            continue;
+        if(++steps > limit)
+            return 0;
+
+        // the whole row at once, stopping where it reads larger
+        size_t mark = labeled.size();
+        int row_less = less;
+        int larger = 0;
+        for(int j = 0; j < dim && !larger; j++)
+        {
+            int v = label(at(r, cols[j]));
+            out[i * dim + j] = v;
+            if(!row_less)
+            {
+                larger = v > best[i * dim + j];
+                row_less = v < best[i * dim + j];
+            }
+        }
+
+        if(!larger)
+        {
+            rows[i] = r;
+            row_used[r] = 1;
+            if(i % nonet == 0)
+            {
+                bands[b] = band;
+                band_used[band] = 1;
+            }
+            int ok = next_row(i + 1, row_less);
+            row_used[r] = 0;
+            if(i % nonet == 0)
+                band_used[band] = 0;
+            if(!ok)
+                return 0;
+        }
+        unlabel(mark);
+    }
+    return 1;
+}
+
+/*
+ * canonical_form()
+ *          Description: Finds the canonical form of a puzzle, the same for
+ *                       every puzzle its symmetries can make, and the
+ *                       symmetry that makes it. Digits missing from the
+ *                       puzzle get the labels left over, in order.
+ *          Input: val -> values of the puzzle, -1 for an empty square
+ *                 dim -> dimension of the puzzle
+ *                 limit -> steps the search may take
+ *                 sym -> filled in with the symmetry
+ *                 key -> filled in with the form, one byte per square
+ *          Output: returns 1 on success, 0 if the search ran out of steps
+ *          Calls: Canonizer.first_row()
+ */
+
+int canonical_form(const int8_t *val, int dim, long limit, Symmetry &sym,
+                   string &key)
+{
+    Canonizer search(val, dim, limit);
+    int n = search.nonet;
+
+    // search the sides whose counts sort first
+    vector<int> profiles[2];
+    for(int t = 0; t < 2; t++)
+    {
+        vector<int> cols;
+        search.transpose = t;
+        search.profile(search.row_count, profiles[t], 1);
+        search.profile(search.col_count, cols, 0);
+        profiles[t].insert(profiles[t].end(), cols.begin(), cols.end());
+    }
+    const vector<int> &first = max(profiles[0], profiles[1]);
+
+    for(int t = 0; t < 2; t++)
+    {
+        if(profiles[t] != first)
+            continue;
+        search.transpose = t;
+        search.profile(search.row_count, search.row_profile, 1);
+        search.profile(search.col_count, search.col_profile, 0);
+        for(int r = 0; r < dim; r++)
+        {
+            if(search.row_count[r] != search.row_profile[0])
+                continue;
+            search.rows[0] = r;
+            search.bands[0] = r / n;
+            search.row_used[r] = 1;
+            search.band_used[r / n] = 1;
+            int ok = search.first_row(0, 0);
+            search.row_used[r] = 0;
+            search.band_used[r / n] = 0;
+            search.unlabel(0);
+            if(!ok)
+                return 0;
+        }
+    }
+
+    // label the digits again along the best form
+    sym = search.found;
+    sym.digits.assign(dim + 1, 0);
+    search.transpose = sym.transpose;
+    int next = 0;
+    for(int i = 0; i < dim; i++)
+    {
+        for(int j = 0; j < dim; j++)
+        {
+            int v = search.at(sym.rows[i], sym.cols[j]);
+            if(v != -1 && !sym.digits[v])
+                sym.digits[v] = ++next;
+        }
+    }
+    for(int v = 1; v <= dim; v++)
+    {
+        if(!sym.digits[v])
+            sym.digits[v] = ++next;
+    }
+
+    key.resize(search.best.size());
+    for(size_t c = 0; c < key.size(); c++)
+        key[c] = (char)search.best[c];
+    return 1;
+}
+
+// Constructor
+SolveCache::SolveCache(size_t entries)
+    : hits(0), misses(0), skipped(0)
+{
+    shards = new Shard[CACHE_SHARDS];
+    capacity = entries;
+
+    // the first entries % CACHE_SHARDS shards hold one more, so the
+    // shards add up to exactly entries
+    for(size_t i = 0; i < CACHE_SHARDS; i++)
+        shards[i].limit = entries / CACHE_SHARDS +
+                          (i < entries % CACHE_SHARDS);
+}
+
+// Destructor
+SolveCache::~SolveCache()
+{
+    delete [] shards;
+}
+
+/*
+ * lookup()
+ *          Description: Looks a puzzle up by its canonical form, and on a
+ *                       hit fills in its values with the cached solution
+ *                       put back through the inverse of the symmetry. The
+ *                       candidates of the board are left as they were.
+ *          Input: board -> puzzle to look up
+ *                 sym, key -> filled in for insert() after a miss, key is
+ *                             empty if the puzzle has no canonical form
+ *          Output: returns 1 on a hit, 0 otherwise
+ *          Calls: canonical_form()
+ */
+
+int SolveCache::lookup(Board &board, Symmetry &sym, string &key)
+{
+    int dim = board.dim;
+    if(!canonical_form(board.val, dim, CANON_LIMIT, sym, key))
+    {
+        key.clear();
+        skipped++;
+        return 0;
+    }
+
+    string solution;
+    Shard &shard = shards[hash<string>()(key) % CACHE_SHARDS];
+    {
+        lock_guard<mutex> guard(shard.lock);
+        auto entry = shard.index.find(key);
+        if(entry != shard.index.end())
+        {
+            shard.order.splice(shard.order.begin(), shard.order,
+                               entry->second);
+            solution = entry->second->second;
+        }
+    }
+    if(solution.empty())
+    {
+        misses++;
+        return 0;
+    }
+
+    vector<int> digit(dim + 1);
+    for(int v = 1; v <= dim; v++)
+        digit[sym.digits[v]] = v;
+    for(int i = 0; i < dim; i++)
+    {
+        for(int j = 0; j < dim; j++)
+        {
+            int r = sym.rows[i];
+            int c = sym.cols[j];
+            int cell = sym.transpose ? c * dim + r : r * dim + c;
+            board.val[cell] = (int8_t)digit[(int)solution[i * dim + j]];
+        }
+    }
+    hits++;
+    return 1;
+}
+
+/*
+ * insert()
+ *          Description: Caches the solution of a puzzle that missed, in
+ *                       canonical form, dropping the least recently used
+ *                       entry of the shard when it is full.
+ *          Input: solution -> solved board of the puzzle
+ *                 sym, key -> from the lookup() that missed
+ *          Output: None
+ *          Calls: None
+ */
+
+void SolveCache::insert(const Board &solution, const Symmetry &sym,
+                        const string &key)
+{
+    int dim = solution.dim;
+    string canonical(key.size(), 0);
+    for(int i = 0; i < dim; i++)
+    {
+        for(int j = 0; j < dim; j++)
+        {
+            int r = sym.rows[i];
+            int c = sym.cols[j];
+            int cell = sym.transpose ? c * dim + r : r * dim + c;
+            canonical[i * dim + j] = (char)sym.digits[solution.val[cell]];
+        }
+    }
+
+    Shard &shard = shards[hash<string>()(key) % CACHE_SHARDS];
+    lock_guard<mutex> guard(shard.lock);
+    if(shard.limit == 0 || shard.index.count(key))
+        return;
+    if(shard.order.size() >= shard.limit)
+    {
+        shard.index.erase(shard.order.back().first);
+        shard.order.pop_back();
+    }
+    shard.order.push_front(make_pair(key, canonical));
+    shard.index[key] = shard.order.begin();
+}
+
+/*
+ * report()
+ *          Description: Prints the hits and misses of the cache, and the
+ *                       puzzles that were too costly to put in canonical
+ *                       form.
+ *          Input: out -> where to print the report
+ *          Output: None
+ *          Calls: None
+ */
+
+void SolveCache::report(FILE *out)
+{
+    long hit = hits;
+    long miss = misses;
+    long skip = skipped;
+    long total = hit + miss + skip;
+    fprintf(out, "Cache: hits: %ld misses: %ld skipped: %ld hit rate: %.1f%%\n",
+            hit, miss, skip, total ? 100.0 * hit / total : 0.0);
+}
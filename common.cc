@@ -1,28 +1,72 @@
 #include <stdio.h>
-#include <unistd.h>
 
 #include "common.h"
 
-static double g_ticks_persecond = 0.0;
+static const char *phase_names[NUM_PHASES] = {
+    "parse",
+    "init",
+    "propagate",
+    "search",
+    "verify",
+    "output"
+};
 
-void InitTSC(void)
+// time charged to each phase, the phase running and since when
+static uint64_t g_phase_ticks[NUM_PHASES];
+static int g_phase = -1;
+static uint64_t g_phase_start = 0;
+
+
+double ElapsedTime(uint64_t ticks)
+{
+    return ticks / 1e9;
+}
+
+
+// charges the running phase up to now and switches to another
+static void SwitchPhase(int p)
 {
-    uint64_t start_tick = ReadTSC();
-    sleep(1);
-    uint64_t end_tick = ReadTSC();
+    uint64_t now = ReadClock();
+    if (g_phase >= 0)
+        g_phase_ticks[g_phase] += now - g_phase_start;
+    g_phase = p;
+    g_phase_start = now;
+}
+
 
-    g_ticks_persecond = (double) (end_tick - start_tick);
-    //fprintf(stderr, "%e ticks per second.\n", g_ticks_persecond);
+ScopedTimer::ScopedTimer(Phase p)
+{
+    outer = g_phase;
+    SwitchPhase(p);
 }
 
 
-double ElapsedTime(uint64_t ticks)
+ScopedTimer::~ScopedTimer()
 {
-    if (g_ticks_persecond == 0.0) {
-        fprintf(stderr, "TSC timer has not been initialized.\n");
-        return 0.0;
-    }
-    else {
-        return (ticks / g_ticks_persecond);
+    SwitchPhase(outer);
+}
+
+
+void ScopedTimer::next(Phase p)
+{
+    SwitchPhase(p);
+}
+
+
+double PhaseTime(Phase p)
+{
+    return ElapsedTime(g_phase_ticks[p]);
+}
+
+
+void ReportPhases(FILE *out)
+{
+    double total = 0.0;
+    fprintf(out, "Phases (ms):\n");
+    for (int p = 0; p < NUM_PHASES; p++) {
+        fprintf(out, "\t%-14s %.3f\n", phase_names[p],
+                PhaseTime((Phase) p) * 1000.0);
+        total += PhaseTime((Phase) p);
     }
+    fprintf(out, "\t%-14s %.3f\n", "total", total * 1000.0);
 }
@@ -3,43 +3,56 @@
 
 #include <stdint.h>
 #include <stdlib.h>
-
-static inline uint64_t ReadTSC(void)
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * Timing uses the monotonic clock, which the kernel already calibrates, so
+ * nothing has to be measured at startup and the same code works on every
+ * architecture. Readings are in nanoseconds.
+ */
+static inline uint64_t ReadClock(void)
 {
-#if defined(__i386__)
-
-    uint64_t x;
-    __asm__ __volatile__(".byte 0x0f, 0x31":"=A"(x));
-    return x;
-
-#elif defined(__x86_64__)
-
-    uint32_t hi, lo;
-    __asm__ __volatile__("rdtsc":"=a"(lo), "=d"(hi));
-    return ((uint64_t) lo) | (((uint64_t) hi) << 32);
-
-#elif defined(__powerpc__)
-
-    uint64_t result = 0;
-    uint64_t upper, lower, tmp;
-    __asm__ __volatile__("0:                  \n"
-                         "\tmftbu   %0           \n"
-                         "\tmftb    %1           \n"
-                         "\tmftbu   %2           \n"
-                         "\tcmpw    %2,%0        \n"
-                         "\tbne     0b         \n":"=r"(upper), "=r"(lower),
-                         "=r"(tmp)
-        );
-    result = upper;
-    result = result << 32;
-    result = result | lower;
-    return result;
-
-#endif // defined(__i386__)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
 }
 
-void InitTSC(void);
-
+// seconds in a difference of two ReadClock() readings
 double ElapsedTime(uint64_t ticks);
 
+/*
+ * Phases of one run of the solver. A ScopedTimer charges the time it is
+ * alive to its phase, and next() moves it on to another phase. A timer
+ * started inside another pauses the outer one, so every nanosecond is
+ * charged to exactly one phase. Timers are only meant for the main thread,
+ * outside of parallel regions.
+ */
+enum Phase
+{
+    PHASE_PARSE,
+    PHASE_INIT,
+    PHASE_PROPAGATE,
+    PHASE_SEARCH,
+    PHASE_VERIFY,
+    PHASE_OUTPUT,
+    NUM_PHASES
+};
+
+class ScopedTimer
+{
+public:
+    ScopedTimer(Phase p);
+    ~ScopedTimer();
+
+    void next(Phase p);
+
+private:
+    int outer;
+};
+
+// time charged to a phase so far, in seconds
+double PhaseTime(Phase p);
+void ReportPhases(FILE *out);
+
 #endif // COMMON_H_
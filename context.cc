@@ -0,0 +1,309 @@
+/*
+ * Author: Luke Vandecasteele
+ *
+ * Credits: Matthew Trappert, Dr. Jee W. Choi, Class notes, and other sources
+ *          listed in final report.
+ *
+ * Date Created: 10/17/2026
+ * Last Modified: 10/17/2026
+ *
+ * Description: Final project for CIS 431 at the University of Oregon Fall
+ *              2021. Implementation of the SolverContext class and the C
+ *              interface of libsdksolver around it.
+ * Notes:
+ *       1. See sdksolver.h for the interface.
+ *       2. All methods contain headers for individual usage and description.
+ *       3. Nothing is allocated per puzzle once a thread has a solver for
+ *          the dimension: the values are loaded straight into its Board,
+ *          the Layout tables are shared, and the search reuses its trail.
+ *       4. No exception leaves the C functions, running out of memory is
+ *          returned as SDK_ERROR. Inside a batch it is caught on the thread
+ *          that threw it, since it may not leave the parallel region.
+ *
+ */
+
+#include <string.h>
+#include "header.h"
+#include "sdksolver.h"
+
+// Constructor
+SolverContext::SolverContext()
+{
+    /* solvers are made by the first call that needs them */
+    cache = NULL;
+}
+
+// Destructor
+SolverContext::~SolverContext()
+{
+    for(unsigned int t = 0; t < solvers.size(); t++)
+        delete solvers[t];
+    delete cache;
+}
+
+/*
+ * use_cache()
+ *          Description: Replaces the cache of solutions with an empty one.
+ *          Input: entries -> puzzles the cache may hold, 0 for no cache
+ *          Output: None
+ *          Calls: None
+ */
+
+void SolverContext::use_cache(long entries)
+{
+    delete cache;
+    cache = NULL;
+    if(entries > 0)
+        cache = new SolveCache(entries);
+}
+
+/*
+ * solver()
+ *          Description: Returns the solver of a thread, making it the first
+ *                       time or when the dimension changes.
+ *          Input: t -> thread number, less than solvers.size()
+ *                 dim -> dimension of the puzzles
+ *          Output: the solver
+ *          Calls: None
+ */
+
+Sudoku* SolverContext::solver(int t, int dim)
+{
+    Sudoku *&puzzle = solvers[t];
+    if(puzzle == NULL || puzzle->dim != dim)
+    {
+        delete puzzle;
+        puzzle = NULL;
+        puzzle = new Sudoku(Board(dim));
+    }
+    return puzzle;
+}
+
+/*
+ * solve_with()
+ *          Description: Loads a puzzle into a solver, checking that every
+ *                       value is in range and no group has one twice, and
+ *                       solves it.
+ *          Input: puzzle -> solver for options.dim
+ *                 in -> the puzzle, see sdksolver.h
+ *                 out -> where the solution goes, the puzzle is copied
+ *                        there unchanged if it is not solved
+ *                 options -> engine and tactics to solve with
+ *          Output: SDK_SOLVED, SDK_NO_SOLUTION, or SDK_BAD_PUZZLE
+ *          Calls: Board.init_candidates(), Sudoku.solve(), solve_fixed()
+ */
+
+int SolverContext::solve_with(Sudoku *puzzle, const uint8_t *in,
+                              uint8_t *out, const SolverOptions &options)
+{
+    Board &board = puzzle->board;
+    const Layout *layout = board.layout;
+    int dim = board.dim;
+    int cells = board.cells;
+
+    // used[] is rebuilt by init_candidates(), until then it
+    // catches a value given twice in a group
+    int bad = 0;
+    memset(board.used, 0, layout->num_groups * sizeof(mask_t));
+    for(int c = 0; c < cells; c++)
+    {
+        int v = in[c];
+        board.val[c] = v ? (int8_t)v : -1;
+        if(v == 0)
+            continue;
+        if(v > dim)
+        {
+            bad = 1;
+            break;
+        }
+        const int *g = layout->groups_of(c);
+        mask_t bit = mask_bit(v);
+        bad |= ((board.used[g[0]] | board.used[g[1]] |
+                 board.used[g[2]]) & bit) != 0;
+        board.used[g[0]] |= bit;
+        board.used[g[1]] |= bit;
+        board.used[g[2]] |= bit;
+    }
+
+    int solved = 0;
+    if(!bad && options.engine == SDK_ENGINE_FIXED && fixed_supported(dim))
+        solved = solve_fixed(board);
+    else if(!bad)
+    {
+        puzzle->engine.tactics = options.tactics;
+        puzzle->cache = cache;
+        board.init_candidates();
+        solved = puzzle->solve();
+    }
+
+    if(!solved)
+    {
+        if(out != in)
+            memmove(out, in, cells);
+        return bad ? SDK_BAD_PUZZLE : SDK_NO_SOLUTION;
+    }
+    for(int c = 0; c < cells; c++)
+        out[c] = (uint8_t)board.val[c];
+    return SDK_SOLVED;
+}
+
+/*
+ * solve()
+ *          Description: Solves one puzzle on the calling thread.
+ *          Input: in -> the puzzle, see sdksolver.h
+ *                 out -> where the solution goes, may be in
+ *                 options -> dimension, engine, and tactics
+ *          Output: SDK_SOLVED, SDK_NO_SOLUTION, or SDK_BAD_PUZZLE
+ *          Calls: solver(), solve_with()
+ */
+
+int SolverContext::solve(const uint8_t *in, uint8_t *out,
+                         const SolverOptions &options)
+{
+    if(!board_dim((size_t)options.dim * options.dim))
+        return SDK_BAD_PUZZLE;
+    if(solvers.empty())
+        solvers.resize(1, NULL);
+    return solve_with(solver(0, options.dim), in, out, options);
+}
+
+/*
+ * solve_batch()
+ *          Description: Solves many puzzles, one puzzle per thread at a
+ *                       time, each thread with its own solver.
+ *          Input: in -> count puzzles, one after another
+ *                 out -> where the solutions go, may be in
+ *                 count -> number of puzzles
+ *                 options -> dimension, engine, tactics, and threads
+ *                 status -> if not NULL, the result of each puzzle
+ *          Output: number of puzzles solved, or SDK_ERROR if memory ran
+ *                  out for any of them. Those puzzles are copied to out
+ *                  unchanged and their status is SDK_ERROR.
+ *          Calls: solver(), solve_with()
+ */
+
+long SolverContext::solve_batch(const uint8_t *in, uint8_t *out, long count,
+                                const SolverOptions &options, int8_t *status)
+{
+    int dim = options.dim;
+    if(!board_dim((size_t)dim * dim))
+    {
+        if(status)
+            memset(status, SDK_BAD_PUZZLE, count);
+        return 0;
+    }
+
+    size_t cells = (size_t)dim * dim;
+    int threads = options.threads > 0 ? options.threads :
+                                        omp_get_max_threads();
+    if(solvers.size() < (size_t)threads)
+        solvers.resize(threads, NULL);
+
+    // solvers are made on the thread that uses them, an exception
+    // must not leave the parallel region so it is caught per puzzle
+    long solved = 0;
+    int error = 0;
+    #pragma omp parallel num_threads(threads) reduction(+:solved) \
+                         reduction(|:error)
+    {
+        Sudoku *puzzle = NULL;
+        try
+        {
+            puzzle = solver(omp_get_thread_num(), dim);
+        }
+        catch(...)
+        {
+            puzzle = NULL;
+        }
+
+        #pragma omp for schedule(dynamic, 64)
+        for(long i = 0; i < count; i++)
+        {
+            int result = SDK_ERROR;
+            if(puzzle)
+            {
+                try
+                {
+                    result = solve_with(puzzle, in + i * cells,
+                                        out + i * cells, options);
+                }
+                catch(...)
+                {
+                    result = SDK_ERROR;
+                }
+            }
+            if(result == SDK_ERROR && out != in)
+                memmove(out + i * cells, in + i * cells, cells);
+            if(status)
+                status[i] = (int8_t)result;
+            solved += result == SDK_SOLVED;
+            error |= result == SDK_ERROR;
+        }
+    }
+    return error ? SDK_ERROR : solved;
+}
+
+
+/* C interface, see sdksolver.h */
+
+struct sdk_context
+{
+    SolverContext context;
+};
+
+void sdk_options_init(sdk_options *options, int dim)
+{
+    options->dim = dim;
+    options->engine = SDK_ENGINE_SERIAL;
+    options->tactics = 0;
+    options->threads = 0;
+}
+
+sdk_context *sdk_context_new(void)
+{
+    return new(nothrow) sdk_context;
+}
+
+void sdk_context_free(sdk_context *ctx)
+{
+    delete ctx;
+}
+
+int sdk_context_cache(sdk_context *ctx, long entries)
+{
+    try
+    {
+        ctx->context.use_cache(entries);
+        return 0;
+    }
+    catch(...)
+    {
+        return SDK_ERROR;
+    }
+}
+
+int sdk_solve(sdk_context *ctx, const uint8_t *in, uint8_t *out,
+              const sdk_options *options)
+{
+    try
+    {
+        return ctx->context.solve(in, out, *options);
+    }
+    catch(...)
+    {
+        return SDK_ERROR;
+    }
+}
+
+long sdk_solve_batch(sdk_context *ctx, const uint8_t *in, uint8_t *out,
+                     long count, const sdk_options *options, int8_t *status)
+{
+    try
+    {
+        return ctx->context.solve_batch(in, out, count, *options, status);
+    }
+    catch(...)
+    {
+        return SDK_ERROR;
+    }
+}
@@ -0,0 +1,343 @@
+/*
+ * Author: Luke Vandecasteele
+ *
+ * Credits: Matthew Trappert, Dr. Jee W. Choi, Class notes, and other sources
+ *          listed in final report. Donald Knuth, "Dancing Links".
+ *
+ * Date Created: 10/16/2026
+ * Last Modified: 10/17/2026
+ *
+ * Description: Final project for CIS 431 at the University of Oregon Fall
+ *              2021. Implementation of the DLX class, an exact cover solver
+ *              used as an alternative to the guess and check search.
+ * Notes:
+ *       1. See header.h for all class methods and variables.
+ *       2. All methods contain headers for individual usage and description.
+ *       3. Always branching on the column with the fewest rows left makes
+ *          the search far more even on puzzles where guess and check
+ *          backtracks heavily, at the cost of a larger setup per puzzle.
+ *
+ */
+
+#include <string.h>
+#include "header.h"
+
+// Constructor
+DLX::DLX(const Board &in)
+    : board(in)
+{
+    layout = board.layout;
+    dim = board.dim;
+    solutions = 0;
+    build();
+}
+
+/*
+ * build()
+ *          Description: Creates the column headers and one row per value
+ *                       that can still go in each cell: the given value for
+ *                       a filled cell, and every candidate of an empty one.
+ *          Input: None
+ *          Output: None
+ *          Calls: add_row()
+ */
+
+void DLX::build()
+{
+    int cells = board.cells;
+    columns = 4 * cells;
+
+    // worst case is every value in every cell
+    size_t nodes = 1 + columns + (size_t)4 * cells * dim;
+    left.clear();
+    right.clear();
+    up.clear();
+    down.clear();
+    column.clear();
+    row.clear();
+    left.reserve(nodes);
+    right.reserve(nodes);
+    up.reserve(nodes);
+    down.reserve(nodes);
+    column.reserve(nodes);
+    row.reserve(nodes);
+    size.assign(columns + 1, 0);
+
+    // root and column headers in one circular list
+    for(int i = 0; i <= columns; i++)
+    {
+        left.push_back(i == 0 ? columns : i - 1);
+        right.push_back(i == columns ? 0 : i + 1);
+        up.push_back(i);
+        down.push_back(i);
+        column.push_back(i);
+        row.push_back(-1);
+    }
+
+    for(int c = 0; c < cells; c++)
+    {
+        if(board.val[c] != -1)
+        {
+            add_row(c, board.val[c]);
+            continue;
+        }
+
+        mask_t cand = board.cand[c];
+        while(cand)
+        {
+            add_row(c, mask_lowest(cand));
+            cand &= cand - 1;
+        }
+    }
+}
+
+/*
+ * add_row()
+ *          Description: Adds the row for placing a value in a cell, one node
+ *                       in each of the four columns it covers.
+ *          Input: cell -> cell index
+ *                 value -> value to place
+ *          Output: None
+ *          Calls: None
+ */
+
+void DLX::add_row(int cell, int value)
+{
+    int cells = board.cells;
+    int r = layout->row(cell);
+    int k = layout->col(cell);
+    int b = layout->groups_of(cell)[2] / 3;
+    int v = value - 1;
+
+    int cols[4] = {
+        1 + cell,
+        1 + cells + r * dim + v,
+        1 + 2 * cells + k * dim + v,
+        1 + 3 * cells + b * dim + v
+    };
+
+    int first = left.size();
+    for(int i = 0; i < 4; i++)
+    {
+        int n = first + i;
+        int c = cols[i];
+
+        left.push_back(i == 0 ? first + 3 : n - 1);
+        right.push_back(i == 3 ? first : n + 1);
+
+        // insert at the bottom of the column
+        up.push_back(up[c]);
+        down.push_back(c);
+        down[up[c]] = n;
+        up[c] = n;
+
+        column.push_back(c);
+        row.push_back(cell * dim + v);
+        size[c]++;
+    }
+}
+
+/*
+ * choose_column()
+ *          Description: Finds the column with the fewest rows left.
+ *          Input: None
+ *          Output: a column index, 0 if every column is covered
+ *          Calls: None
+ */
+
+int DLX::choose_column()
+{
+    int best = 0;
+    int min_size = -1;
+    for(int c = right[0]; c != 0; c = right[c])
+    {
+        if(min_size == -1 || size[c] < min_size)
+        {
+            best = c;
+            min_size = size[c];
+            if(min_size <= 1)
+                break;
+        }
+    }
+    return best;
+}
+
+/*
+ * cover()
+ *          Description: Removes a column and every row that has a node in
+ *                       it from the matrix.
+ *          Input: c -> column index
+ *          Output: None
+ *          Calls: None
+ */
+
+void DLX::cover(int c)
+{
+    right[left[c]] = right[c];
+    left[right[c]] = left[c];
+    for(int i = down[c]; i != c; i = down[i])
+    {
+        for(int j = right[i]; j != i; j = right[j])
+        {
+            down[up[j]] = down[j];
+            up[down[j]] = up[j];
+            size[column[j]]--;
+        }
+    }
+}
+
+/*
+ * uncover()
+ *          Description: Puts back a column removed by cover(), in exactly
+ *                       the reverse order.
+ *          Input: c -> column index
+ *          Output: None
+ *          Calls: None
+ */
+
+void DLX::uncover(int c)
+{
+    for(int i = up[c]; i != c; i = up[i])
+    {
+        for(int j = left[i]; j != i; j = left[j])
+        {
+            size[column[j]]++;
+            down[up[j]] = j;
+            up[down[j]] = j;
+        }
+    }
+    right[left[c]] = c;
+    left[right[c]] = c;
+}
+
+/*
+ * record()
+ *          Description: Writes the rows chosen so far into the board.
+ *          Input: None
+ *          Output: None
+ *          Calls: Board.assign()
+ */
+
+void DLX::record()
+{
+    memset(board.val, -1, board.cells);
+    memset(board.used, 0, layout->num_groups * sizeof(mask_t));
+    for(unsigned int i = 0; i < chosen.size(); i++)
+    {
+        int r = row[chosen[i]];
+        board.assign(r / dim, r % dim + 1);
+    }
+}
+
+/*
+ * solve()
+ *          Description: Algorithm X without recursion. chosen holds the row
+ *                       tried at each level; stepping to the next row of a
+ *                       column undoes the covers of the previous one.
+ *                       Columns branched on, rows tried, and rows backed
+ *                       out of are counted in stats.
+ *          Input: limit -> stop after this many solutions, 0 to count them
+ *                          all
+ *          Output: number of solutions found, the first is left in board
+ *          Calls: choose_column(), cover(), uncover(), record()
+ */
+
+long DLX::solve(long limit)
+{
+    solutions = 0;
+    chosen.clear();
+
+    int forward = 1;
+    for(;;)
+    {
+        int r;
+        if(forward)
+        {
+            // every column covered, the chosen rows are a solution
+            if(right[0] == 0)
+            {
+                if(solutions == 0)
+                    record();
+                solutions++;
+                if(limit && solutions >= limit)
+                    break;
+                forward = 0;
+                continue;
+            }
+
+            int c = choose_column();
+            cover(c);
+            r = down[c];
+            chosen.push_back(r);
+            STAT_ADD(stats, nodes, 1);
+            STAT_MAX(stats, max_depth, chosen.size());
+        }
+        else
+        {
+            // back out of the row tried at the deepest level
+            if(chosen.empty())
+                break;
+            int prev = chosen.back();
+            for(int j = left[prev]; j != prev; j = left[j])
+                uncover(column[j]);
+            r = down[prev];
+            chosen.back() = r;
+            STAT_ADD(stats, backtracks, 1);
+        }
+
+        // column has no rows left to try
+        if(r == column[r])
+        {
+            uncover(r);
+            chosen.pop_back();
+            forward = 0;
+            continue;
+        }
+
+        for(int j = right[r]; j != r; j = right[j])
+            cover(column[j]);
+        STAT_ADD(stats, guesses, 1);
+        forward = 1;
+    }
+
+    // leave the matrix as it was built
+    while(!chosen.empty())
+    {
+        int prev = chosen.back();
+        for(int j = left[prev]; j != prev; j = left[j])
+            uncover(column[j]);
+        uncover(column[prev]);
+        chosen.pop_back();
+    }
+    return solutions;
+}
+
+/*
+ * print()
+ *          Description: Prints current state of puzzle to stdout.
+ *          Input: None
+ *          Output: None
+ *          Calls: None
+ */
+
+void DLX::print()
+{
+    cout << "Dimension: " << dim << endl;
+    cout << "Puzzle: " << endl;
+
+    for(int i = 0; i < dim; i++)
+    {
+        cout << "\t";
+        for(int j = 0; j < dim; j++)
+        {
+            // numbers once the letters run out
+            int v = board.val[i * dim + j];
+            if(dim > TOKEN_DIM)
+                cout << setw(token_width(dim)) << (v == -1 ? 0 : v);
+            else
+                cout << encode_value(v, dim);
+            cout << " ";
+        }
+        cout << endl;
+    }
+}
@@ -0,0 +1,82 @@
+/*
+ * Author: Luke Vandecasteele
+ *
+ * Credits: Matthew Trappert, Dr. Jee W. Choi, Class notes, and other sources
+ *          listed in final report.
+ *
+ * Date Created: 10/16/2026
+ * Last Modified: 10/16/2026
+ *
+ * Description: Final project for CIS 431 at the University of Oregon Fall
+ *              2021. Picks the FixedSudoku instantiation that matches a
+ *              puzzle's box size.
+ * Notes:
+ *       1. See fixed.h for the solver itself.
+ *       2. Each thread keeps one solver per box size, so its search stack
+ *          is only allocated the first time.
+ *
+ */
+
+#include "fixed.h"
+
+/*
+ * solve_with()
+ *          Description: Solves a board with this thread's solver for box
+ *                       size N.
+ *          Input: board -> puzzle to solve
+ *          Output: returns 1 if the puzzle was solved, 0 otherwise
+ *          Calls: FixedSudoku.solve()
+ */
+
+template <int N>
+static int solve_with(Board &board)
+{
+    static thread_local FixedSudoku<N> *solver = NULL;
+    if(solver == NULL)
+        solver = new FixedSudoku<N>();
+    return solver->solve(board);
+}
+
+/*
+ * fixed_supported()
+ *          Description: Checks if there is a specialized solver for a
+ *                       dimension.
+ *          Input: dim -> dimension of the puzzle
+ *          Output: returns 1 if solve_fixed() can solve it, 0 otherwise
+ *          Calls: None
+ */
+
+int fixed_supported(int dim)
+{
+    return dim == 4 || dim == 9 || dim == 16 || dim == 25 || dim == 36 ||
+           dim == 49;
+}
+
+/*
+ * solve_fixed()
+ *          Description: Solves a board with the solver compiled for its box
+ *                       size. The solution is written back into the board.
+ *          Input: board -> puzzle to solve, fixed_supported(board.dim)
+ *          Output: returns 1 if the puzzle was solved, 0 otherwise
+ *          Calls: solve_with()
+ */
+
+int solve_fixed(Board &board)
+{
+    switch(board.dim)
+    {
+        case 4:
+            return solve_with<2>(board);
+        case 9:
+            return solve_with<3>(board);
+        case 16:
+            return solve_with<4>(board);
+        case 25:
+            return solve_with<5>(board);
+        case 36:
+            return solve_with<6>(board);
+        case 49:
+            return solve_with<7>(board);
+    }
+    return 0;
+}
@@ -0,0 +1,352 @@
+/*
+ * Author: Luke Vandecasteele
+ *
+ * Credits: Matthew Trappert, Dr. Jee W. Choi, Class notes, and other sources
+ *          listed in final report.
+ *
+ * Date Created: 10/16/2026
+ * Last Modified: 10/16/2026
+ *
+ * Description: Final project for CIS 431 at the University of Oregon Fall
+ *              2021. Header file for FixedSudoku, a serial solver whose
+ *              box size is a template parameter.
+ * Notes:
+ *       1. Every dimension, table, and loop bound is known when the solver
+ *          is compiled, so the compiler can unroll the loops over a cell's
+ *          peers and a group's cells, and candidates are kept in the
+ *          smallest mask that fits: 16 bits up to 16x16, 32 bits up to
+ *          25x25, and 64 bits above.
+ *       2. Only included by fixed.cc, the rest of the program calls
+ *          solve_fixed() declared in header.h.
+ *
+ */
+
+#ifndef FIXED_H_
+#define FIXED_H_
+
+#include <type_traits>
+#include "header.h"
+
+
+/*
+ * FixedTables holds the index tables for one box size, built by the compiler.
+ * group[g] is laid out like Layout::groups (3i row, 3i + 1 col, 3i + 2 nonet)
+ * and peer[c] lists every other cell sharing a group with cell c.
+ */
+template <int N>
+struct FixedTables
+{
+    static constexpr int D = N * N;
+    static constexpr int C = D * D;
+    static constexpr int G = 3 * D;
+    static constexpr int P = 3 * (D - 1) - 2 * (N - 1);
+
+    int16_t group[G][D];
+    int16_t peer[C][P];
+
+    constexpr FixedTables()
+        : group(), peer()
+    {
+        for(int i = 0; i < D; i++)
+        {
+            for(int k = 0; k < D; k++)
+            {
+                group[3 * i][k] = i * D + k;
+                group[3 * i + 1][k] = k * D + i;
+                group[3 * i + 2][k] = ((i / N) * N + k / N) * D +
+                                      (i % N) * N + k % N;
+            }
+        }
+
+        for(int c = 0; c < C; c++)
+        {
+            int r = c / D;
+            int col = c % D;
+            int b = (r / N) * N + col / N;
+            int n = 0;
+
+            // row and col, then the rest of the nonet
+            for(int k = 0; k < D; k++)
+            {
+                if(k != col)
+                    peer[c][n++] = r * D + k;
+            }
+            for(int k = 0; k < D; k++)
+            {
+                if(k != r)
+                    peer[c][n++] = k * D + col;
+            }
+            for(int k = 0; k < D; k++)
+            {
+                int p = group[3 * b + 2][k];
+                if(p / D != r && p % D != col)
+                    peer[c][n++] = p;
+            }
+        }
+    }
+};
+
+
+template <int N>
+class FixedSudoku
+{
+public:
+
+    static constexpr int D = N * N;
+    static constexpr int C = D * D;
+    static constexpr int G = 3 * D;
+    static constexpr int P = FixedTables<N>::P;
+
+    typedef typename conditional<(D <= 16), uint16_t,
+            typename conditional<(D <= 32), uint32_t,
+                                 uint64_t>::type>::type fmask;
+
+    static constexpr fmask ALL = (fmask)((((uint64_t)1) << D) - 1);
+    static constexpr FixedTables<N> tables = FixedTables<N>();
+
+    // state of the puzzle, copied whole at every guess
+    struct State
+    {
+        fmask cand[C];
+        int8_t val[C];
+        int left;
+    };
+
+    // one level per guessed cell, levels[0] holds the propagated puzzle
+    struct Level
+    {
+        State state;
+        int cell;
+        fmask options;
+    };
+    vector<Level> levels;
+
+    // cells left with one candidate, waiting to be placed
+    int16_t singles[C];
+    int num_singles;
+
+    static int count(fmask m) { return __builtin_popcountll(m); }
+    static int lowest(fmask m) { return __builtin_ctzll(m) + 1; }
+
+    /*
+     * assign()
+     *          Description: Places a value and removes it from the
+     *                       candidates of every peer, queueing peers left
+     *                       with a single candidate.
+     *          Input: s -> state to modify
+     *                 c -> cell index
+     *                 v -> value, must still be a candidate of the cell
+     *          Output: returns 0 if a peer was left without candidates, 1
+     *                  otherwise
+     *          Calls: None
+     */
+    int assign(State &s, int c, int v)
+    {
+        fmask bit = (fmask)1 << (v - 1);
+        if(!(s.cand[c] & bit))
+            return 0;
+
+        s.val[c] = v;
+        s.cand[c] = 0;
+        s.left--;
+
+        const int16_t *peer = tables.peer[c];
+        for(int i = 0; i < P; i++)
+        {
+            int q = peer[i];
+            fmask m = s.cand[q];
+            if(m & bit)
+            {
+                m &= ~bit;
+                s.cand[q] = m;
+                if(m == 0)
+                    return 0;
+                if((m & (m - 1)) == 0)
+                    singles[num_singles++] = q;
+            }
+        }
+        return 1;
+    }
+
+    /*
+     * propagate()
+     *          Description: Places queued naked singles, then looks for
+     *                       hidden singles in every group, until neither
+     *                       finds anything new.
+     *          Input: s -> state to propagate
+     *          Output: returns 0 if a contradiction was found, 1 otherwise
+     *          Calls: assign()
+     */
+    int propagate(State &s)
+    {
+        for(;;)
+        {
+            while(num_singles)
+            {
+                int q = singles[--num_singles];
+                if(s.val[q] != -1)
+                    continue;
+                if(!assign(s, q, lowest(s.cand[q])))
+                    return 0;
+            }
+            if(!s.left)
+                return 1;
+
+            int found = 0;
+            for(int g = 0; g < G; g++)
+            {
+                const int16_t *cells = tables.group[g];
+                fmask once = 0;
+                fmask twice = 0;
+                fmask placed = 0;
+                for(int k = 0; k < D; k++)
+                {
+                    int c = cells[k];
+                    fmask m = s.cand[c];
+                    twice |= once & m;
+                    once |= m;
+                    if(s.val[c] != -1)
+                        placed |= (fmask)1 << (s.val[c] - 1);
+                }
+
+                // a value with nowhere to go
+                if((once | placed) != ALL)
+                    return 0;
+
+                fmask lone = once & ~twice;
+                while(lone)
+                {
+                    fmask bit = lone & -lone;
+                    lone &= lone - 1;
+
+                    int k = 0;
+                    while(k < D && !(s.cand[cells[k]] & bit))
+                        k++;
+
+                    // its only cell took another lone value
+                    if(k == D)
+                        return 0;
+                    if(!assign(s, cells[k], lowest(bit)))
+                        return 0;
+                    found = 1;
+                }
+            }
+            if(!found && !num_singles)
+                return 1;
+        }
+    }
+
+    /*
+     * min_choice_tile()
+     *          Description: Finds the empty cell with the fewest candidates.
+     *          Input: s -> state to search
+     *          Output: a cell index, -1 if no empty cell was found
+     *          Calls: None
+     */
+    static int min_choice_tile(const State &s)
+    {
+        int choice = -1;
+        int best = D + 1;
+        for(int c = 0; c < C; c++)
+        {
+            if(s.val[c] != -1)
+                continue;
+            int n = count(s.cand[c]);
+            if(n < best)
+            {
+                choice = c;
+                best = n;
+                if(n <= 2)
+                    break;
+            }
+        }
+        return choice;
+    }
+
+    /*
+     * solve()
+     *          Description: Places the given values, propagates, then guesses
+     *                       depth first, copying the state at each guess.
+     *                       The solution, if any, is written back into the
+     *                       board.
+     *          Input: board -> puzzle of dimension D
+     *          Output: returns 1 if the puzzle was solved, 0 otherwise
+     *          Calls: assign(), propagate(), min_choice_tile()
+     */
+    int solve(Board &board)
+    {
+        if(levels.empty())
+            levels.resize(16);
+
+        State &root = levels[0].state;
+        for(int c = 0; c < C; c++)
+        {
+            root.cand[c] = ALL;
+            root.val[c] = -1;
+        }
+        root.left = C;
+        num_singles = 0;
+
+        for(int c = 0; c < C; c++)
+        {
+            if(board.val[c] != -1 && !assign(root, c, board.val[c]))
+                return 0;
+        }
+        if(!propagate(root))
+            return 0;
+
+        int depth = 0;
+        int solved = root.left == 0;
+        if(!solved)
+        {
+            levels[0].cell = min_choice_tile(root);
+            levels[0].options = root.cand[levels[0].cell];
+        }
+
+        while(!solved && depth >= 0)
+        {
+            if(levels[depth].options == 0)
+            {
+                depth--;
+                continue;
+            }
+
+            fmask options = levels[depth].options;
+            fmask bit = options & -options;
+            levels[depth].options = options & (options - 1);
+
+            if((int)levels.size() <= depth + 1)
+                levels.resize(levels.size() * 2);
+
+            State &next = levels[depth + 1].state;
+            next = levels[depth].state;
+            num_singles = 0;
+            if(!assign(next, levels[depth].cell, lowest(bit)) ||
+               !propagate(next))
+                continue;
+
+            depth++;
+            if(next.left == 0)
+            {
+                solved = 1;
+                break;
+            }
+            levels[depth].cell = min_choice_tile(next);
+            levels[depth].options = next.cand[levels[depth].cell];
+        }
+
+        if(solved)
+        {
+            const State &s = levels[depth].state;
+            for(int c = 0; c < C; c++)
+                board.val[c] = s.val[c];
+            board.init_candidates();
+        }
+        return solved;
+    }
+};
+
+template <int N>
+constexpr FixedTables<N> FixedSudoku<N>::tables;
+
+#endif
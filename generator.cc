@@ -0,0 +1,397 @@
+/*
+ * Author: Luke Vandecasteele
+ *
+ * Credits: Matthew Trappert, Dr. Jee W. Choi, Class notes, and other sources
+ *          listed in final report.
+ *
+ * Date Created: 10/16/2026
+ * Last Modified: 10/17/2026
+ *
+ * Description: Final project for CIS 431 at the University of Oregon Fall
+ *              2021. Implementation of the Generator class, which makes
+ *              puzzles with a unique solution at a chosen difficulty, one
+ *              candidate puzzle per thread at a time.
+ * Notes:
+ *       1. See header.h for all class methods and variables.
+ *       2. All methods contain headers for individual usage and description.
+ *       3. Full grids are found by the serial search on an empty board,
+ *          guessing the candidates of every tile in random order, so they
+ *          come from the whole space of solution grids. From FILL_SEARCH_DIM
+ *          up, or when the search runs out of budget, a fixed pattern with
+ *          its digits, bands, stacks, and the rows and cols inside them
+ *          shuffled, and maybe transposed, is used instead. Those grids are
+ *          all alike up to symmetry.
+ *       4. A puzzle the solver can finish by propagation alone has exactly
+ *          one solution, so the grade check is also the uniqueness check
+ *          until guessing is needed. Only then are solutions counted, up
+ *          to 2 with a guess budget, and a clue whose check runs out of
+ *          budget is kept.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "header.h"
+
+// guesses allowed for one uniqueness check of a 9x9, less for larger
+// boards where every guess costs more
+#define GENERATOR_BUDGET 10000
+// smallest dimension whose full grids come from the pattern, the search
+// is too slow there
+#define FILL_SEARCH_DIM 36
+// guesses the search for a full grid may make, and how often it is tried
+#define FILL_BUDGET 100000
+#define FILL_TRIES 4
+
+const char *grade_names[NUM_GRADES] = {
+    "any",
+    "easy",
+    "medium",
+    "hard",
+    "expert"
+};
+
+/*
+ * parse_grade()
+ *          Description: Converts a grade name to a Grade.
+ *          Input: name -> any, easy, medium, hard, or expert
+ *          Output: the grade, -1 if the name is unknown
+ *          Calls: None
+ */
+
+int parse_grade(const char *name)
+{
+    for(int g = 0; g < NUM_GRADES; g++)
+    {
+        if(strcmp(name, grade_names[g]) == 0)
+            return g;
+    }
+    return -1;
+}
+
+// Constructor
+Generator::Generator(int n, int g, unsigned long s)
+{
+    dim = n;
+    grade = g;
+    seed = s;
+    made = 0;
+    rejected = 0;
+    seconds = 0.0;
+    for(int i = 0; i < NUM_GRADES; i++)
+        graded[i] = 0;
+}
+
+/*
+ * shuffle_lines()
+ *          Description: Random order of rows (or cols) that keeps every box
+ *                       whole: the bands are shuffled, then the rows inside
+ *                       each band.
+ *          Input: lines -> filled in with the order, one entry per row
+ *                 n -> box size
+ *                 rng -> random numbers
+ *          Output: None
+ *          Calls: None
+ */
+
+static void shuffle_lines(vector<int> &lines, int n, mt19937_64 &rng)
+{
+    vector<int> bands(n);
+    vector<int> inner(n);
+    for(int i = 0; i < n; i++)
+        bands[i] = i;
+    shuffle(bands.begin(), bands.end(), rng);
+
+    for(int b = 0; b < n; b++)
+    {
+        for(int i = 0; i < n; i++)
+            inner[i] = i;
+        shuffle(inner.begin(), inner.end(), rng);
+        for(int i = 0; i < n; i++)
+            lines[b * n + i] = bands[b] * n + inner[i];
+    }
+}
+
+/*
+ * pattern_fill()
+ *          Description: Makes a full grid from a fixed pattern by shuffling
+ *                       its digits, bands, stacks, rows, and cols, and maybe
+ *                       transposing it.
+ *          Input: grid -> board to overwrite
+ *                 rng -> random numbers
+ *          Output: None
+ *          Calls: shuffle_lines()
+ */
+
+static void pattern_fill(Board &grid, mt19937_64 &rng)
+{
+    int dim = grid.dim;
+    int n = grid.layout->nonet;
+    vector<int> rows(dim);
+    vector<int> cols(dim);
+    vector<int> digits(dim);
+
+    shuffle_lines(rows, n, rng);
+    shuffle_lines(cols, n, rng);
+    for(int v = 0; v < dim; v++)
+        digits[v] = v + 1;
+    shuffle(digits.begin(), digits.end(), rng);
+    int flip = rng() & 1;
+
+    for(int r = 0; r < dim; r++)
+    {
+        for(int c = 0; c < dim; c++)
+        {
+            int pr = flip ? cols[c] : rows[r];
+            int pc = flip ? rows[r] : cols[c];
+            grid.val[r * dim + c] = digits[(n * (pr % n) + pr / n + pc) % dim];
+        }
+    }
+}
+
+/*
+ * fill()
+ *          Description: Makes a random full grid by searching an empty board
+ *                       with the candidates of every tile guessed in random
+ *                       order. Falls back to pattern_fill() for large boards
+ *                       or when every try runs out of budget.
+ *          Input: grid -> board of dimension dim to overwrite
+ *                 maker -> solver of dimension dim, guessing with rng
+ *                 rng -> random numbers
+ *          Output: None
+ *          Calls: Sudoku.count(), pattern_fill()
+ */
+
+void Generator::fill(Board &grid, Sudoku &maker, mt19937_64 &rng)
+{
+    for(int t = 0; dim < FILL_SEARCH_DIM && t < FILL_TRIES; t++)
+    {
+        memset(maker.board.val, -1, maker.board.cells);
+        maker.board.init_candidates();
+        if(maker.count(1) == 1)
+        {
+            memcpy(grid.val, maker.board.val, grid.cells);
+            return;
+        }
+    }
+    pattern_fill(grid, rng);
+}
+
+/*
+ * naked_singles()
+ *          Description: Fills cells that have a single candidate left, and
+ *                       nothing else, until no such cell is left.
+ *          Input: board -> board with candidates set, modified in place
+ *          Output: returns 1 if that filled the whole board, 0 otherwise
+ *          Calls: Board.assign()
+ */
+
+static int naked_singles(Board &board)
+{
+    const Layout *layout = board.layout;
+    int progress = 1;
+    int left = 0;
+    while(progress)
+    {
+        progress = 0;
+        left = 0;
+        for(int c = 0; c < board.cells; c++)
+        {
+            if(board.val[c] != -1)
+                continue;
+            const int *g = layout->groups_of(c);
+            mask_t m = board.cand[c] &
+                       ~(board.used[g[0]] | board.used[g[1]] | board.used[g[2]]);
+            if(m == 0)
+                return 0;
+            if((m & (m - 1)) == 0)
+            {
+                board.assign(c, mask_lowest(m));
+                progress = 1;
+            }
+            else
+                left++;
+        }
+    }
+    return left == 0;
+}
+
+/*
+ * rate()
+ *          Description: Grades a puzzle by the weakest deductions that solve
+ *                       it, trying naked singles, then elimination and
+ *                       lone_ranger, then the optional tactics.
+ *          Input: puzzle -> puzzle to grade
+ *                 singles -> solver with no optional tactics
+ *                 tactics -> solver with every optional tactic
+ *          Output: GRADE_EASY to GRADE_EXPERT, GRADE_EXPERT when guessing
+ *                  is needed or the solution is not unique
+ *          Calls: naked_singles(), Sudoku.propagate(), Sudoku.is_complete()
+ */
+
+int Generator::rate(const Board &puzzle, Sudoku &singles, Sudoku &tactics)
+{
+    singles.board = puzzle;
+    singles.board.init_candidates();
+    if(naked_singles(singles.board))
+        return GRADE_EASY;
+
+    singles.board = puzzle;
+    singles.board.init_candidates();
+    if(singles.propagate() && singles.is_complete())
+        return GRADE_MEDIUM;
+
+    tactics.board = puzzle;
+    tactics.board.init_candidates();
+    if(tactics.propagate() && tactics.is_complete())
+        return GRADE_HARD;
+    return GRADE_EXPERT;
+}
+
+/*
+ * carve()
+ *          Description: Removes the clues of a full grid in random order,
+ *                       putting back any whose removal leaves more than one
+ *                       solution or makes the puzzle harder than grade.
+ *          Input: puzzle -> full grid, left holding the puzzle
+ *                 check -> solver for counting solutions
+ *                 singles, tactics -> solvers for rate()
+ *                 rng -> random numbers
+ *          Output: the grade of the puzzle left
+ *          Calls: rate(), Sudoku.count()
+ */
+
+int Generator::carve(Board &puzzle, Sudoku &check, Sudoku &singles,
+                     Sudoku &tactics, mt19937_64 &rng)
+{
+    vector<int> order(puzzle.cells);
+    for(int c = 0; c < puzzle.cells; c++)
+        order[c] = c;
+    shuffle(order.begin(), order.end(), rng);
+
+    for(int i = 0; i < puzzle.cells; i++)
+    {
+        int c = order[i];
+        int v = puzzle.val[c];
+        puzzle.val[c] = -1;
+
+        // solving without guesses proves the solution unique,
+        // only count solutions when that fails
+        int g = rate(puzzle, singles, tactics);
+        int keep;
+        if(grade != GRADE_ANY && grade != GRADE_EXPERT)
+            keep = g <= grade;
+        else if(g < GRADE_EXPERT)
+            keep = 1;
+        else
+        {
+            check.board = puzzle;
+            check.board.init_candidates();
+            keep = check.count(2) == 1;
+        }
+        if(!keep)
+            puzzle.val[c] = v;
+    }
+    return rate(puzzle, singles, tactics);
+}
+
+/*
+ * generate()
+ *          Description: Makes puzzles on every thread until count of them
+ *                       have the grade asked for, writing each one as a
+ *                       line of characters, or numbers past TOKEN_DIM, as
+ *                       soon as it is made. Each thread has its own random
+ *                       numbers, seeded from seed and the thread number.
+ *          Input: count -> puzzles to make
+ *                 out -> where to write them
+ *          Output: None
+ *          Calls: fill(), carve(), encode_value(), encode_tokens()
+ */
+
+void Generator::generate(long count, FILE *out)
+{
+    uint64_t start = ReadClock();
+    atomic<long> written(0);
+    long rejects = 0;
+    int cells = dim * dim;
+
+    #pragma omp parallel reduction(+:rejects)
+    {
+        int tid = omp_get_thread_num();
+        mt19937_64 rng(seed + 0x9e3779b97f4a7c15ULL * (tid + 1));
+
+        Board grid(dim);
+        Sudoku check(grid);
+        Sudoku singles(grid);
+        Sudoku tactics(grid);
+        Sudoku maker(grid);
+        check.budget = GENERATOR_BUDGET * 81 / cells;
+        maker.budget = FILL_BUDGET;
+        maker.rng = &rng;
+        maker.engine.tactics = 0;
+        singles.engine.tactics = 0;
+        tactics.engine.tactics = TACTICS_ALL;
+
+        // boards larger than TOKEN_DIM are written as numbers
+        int numeric = dim > TOKEN_DIM;
+        size_t width = numeric ? cells * (token_width(dim) + 1) : cells + 1;
+        vector<char> line(width);
+        line[width - 1] = '\n';
+
+        while(written.load() < count)
+        {
+            fill(grid, maker, rng);
+            int g = carve(grid, check, singles, tactics, rng);
+            if(grade != GRADE_ANY && g != grade)
+            {
+                rejects++;
+                continue;
+            }
+
+            if(numeric)
+                encode_tokens(grid.val, cells, dim, line.data());
+            else
+            {
+                for(int c = 0; c < cells; c++)
+                    line[c] = encode_value(grid.val[c], dim);
+            }
+
+            #pragma omp critical(generator_output)
+            {
+                if(made < count)
+                {
+                    fwrite(line.data(), 1, width, out);
+                    made++;
+                    graded[g]++;
+                    written++;
+                }
+            }
+        }
+    }
+
+    fflush(out);
+    rejected = rejects;
+    seconds = ElapsedTime(ReadClock() - start);
+}
+
+/*
+ * summary()
+ *          Description: Prints how many puzzles were made, of which grades,
+ *                       and how fast.
+ *          Input: out -> where to print the summary
+ *          Output: None
+ *          Calls: None
+ */
+
+void Generator::summary(FILE *out)
+{
+    fprintf(out, "Generated: %ld rejected: %ld seed: %lu\n",
+            made, rejected, seed);
+    fprintf(out, "Time to generate: %g threads: %d puzzles/sec: %.1f\n",
+            seconds, omp_get_max_threads(),
+            seconds > 0.0 ? made / seconds : 0.0);
+    fprintf(out, "Grades:");
+    for(int g = GRADE_EASY; g < NUM_GRADES; g++)
+        fprintf(out, " %s %ld", grade_names[g], graded[g]);
+    fprintf(out, "\n");
+}
@@ -5,15 +5,17 @@
  *          listed in final report.
  *
  * Date Created: 11/8/2021
- * Last Modified: 12/1/2021
+ * Last Modified: 10/17/2026
  *
  * Description: Final project for CIS 431 at the University of Oregon Fall
- *              2021. Header file for Tile, Sudoku, and Parallel classes. 
+ *              2021. Header file for Tile, Layout, Board, Sudoku, and Parallel
+ *              classes. 
  *              Sudoku class contains the serial implementation of the solver
  *              while the Parallel class is clearlly the parallel version. 
  * Notes: 
- *       1. The classes, Sudoku and Parallel, contain a 2x2 grid of Tile class
- *          objects.
+ *       1. The classes, Sudoku and Parallel, contain a Board holding the
+ *          values and candidates of every square in one contiguous buffer.
+ *          Squares are addressed by cell index (row * dim + col).
  *       2. All attributes of the classes are public for simplicity and ease of
  *          use.
  *
@@ -21,34 +23,95 @@
 
 // forward declarations
 class Tile;
+class Layout;
+class Board;
+class Trail;
+class Propagator;
 class Sudoku;
+class Batch;
+class DLX;
+class PuzzleReader;
+class PackedWriter;
+class BoardPool;
+class Generator;
+class Server;
+class TaskSearch;
+class SolveCache;
 
 
 #ifndef HEADER_H_
 #define HEADER_H_
 
 #include <iostream>
+#include <iomanip>
+#include <string>
+#include <stdio.h>
 #include <vector>
 #include <math.h>
 #include <set>
 #include <algorithm>
 #include <unistd.h>
+#include <sched.h>
 #include <omp.h>
 #include <stack>
+#include <stdint.h>
+#include <deque>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <random>
+#include "common.h"
+#include "sdksolver.h"
 
 
 using namespace std;
 
 
+// candidate domains are stored as bitmasks where bit (v - 1) is set when
+// value v is still available. One 64 bit word covers boards up to 64x64.
+// Built with WIDE_MASKS (make WIDE=1) a mask is two words, which covers
+// 100x100 and 121x121 at the cost of twice the memory per cell.
+#ifdef WIDE_MASKS
+typedef unsigned __int128 mask_t;
+
+static inline int mask_count(mask_t m)
+{
+    return __builtin_popcountll((uint64_t)m) +
+           __builtin_popcountll((uint64_t)(m >> 64));
+}
+static inline int mask_lowest(mask_t m)
+{
+    uint64_t low = (uint64_t)m;
+    if(low)
+        return __builtin_ctzll(low) + 1;
+    return __builtin_ctzll((uint64_t)(m >> 64)) + 65;
+}
+#else
+typedef uint64_t mask_t;
+
+static inline int mask_count(mask_t m) { return __builtin_popcountll(m); }
+static inline int mask_lowest(mask_t m) { return __builtin_ctzll(m) + 1; }
+#endif
+
+// largest dimension a mask can hold, also used for the cells of one group
+#define MAX_DIM ((int)(8 * sizeof(mask_t)))
+
+static inline mask_t mask_bit(int val) { return (mask_t)1 << (val - 1); }
+static inline mask_t mask_all(int n)
+{
+    return n >= MAX_DIM ? ~(mask_t)0 : ((mask_t)1 << n) - 1;
+}
+
+
 class Tile
 {
 public:
 
     // basic attributes
+    // a Tile records a single value placed into the puzzle
 	int row;
 	int col;
 	int val;
-	vector<int> candidates;
 
 	// constructors
 	Tile();
@@ -59,74 +122,686 @@ public:
 
 	// helper functions
 	void print();
-	void gen_candidates(vector<int> choices);
-    int remove_candidates(vector<int> used_values);
 
 };
 
 
+/*
+ * Layout holds the index tables shared by every Board of one dimension.
+ * Groups are numbered the same way the solvers have always ordered them:
+ * row i is group 3i, column i is group 3i + 1 and nonet i is group 3i + 2.
+ */
+class Layout
+{
+public:
+
+    int dim;
+    int nonet;
+    int cells;
+    int num_groups;
+
+    // groups[g * dim + k] is the k'th cell of group g
+    vector<int> groups;
+    // cell_groups[c * 3 + k] is the row, col, and nonet group of cell c
+    vector<int> cell_groups;
+
+    // Constructor
+    Layout(int n);
+
+    // tables are built once per dimension and shared
+    static const Layout* get(int n);
+
+    const int* group(int g) const { return &groups[g * dim]; }
+    const int* groups_of(int c) const { return &cell_groups[c * 3]; }
+    int row(int c) const { return c / dim; }
+    int col(int c) const { return c % dim; }
+};
+
+
+/*
+ * Trail is an undo log for a Board. While a Board has a trail attached,
+ * every candidate, used value, and cell value it overwrites is recorded so
+ * that the search can roll back to a marker instead of saving a copy of
+ * the whole board at every guess.
+ */
+class Trail
+{
+public:
+
+    // slot numbers the cand array first, then used, then val
+    struct Entry
+    {
+        int slot;
+        mask_t old;
+    };
+    vector<Entry> entries;
+
+    size_t mark() const { return entries.size(); }
+    void record(int slot, mask_t old)
+    {
+        Entry e = {slot, old};
+        entries.push_back(e);
+    }
+    void undo(Board &board, size_t marker);
+    void clear() { entries.clear(); }
+};
+
+
+/*
+ * Board stores the state of a puzzle in a single cache-line aligned
+ * structure-of-arrays buffer: the candidates of each cell, the used values
+ * of each group, and the value of each cell (-1 when empty). Copying a
+ * Board is one memcpy of that buffer.
+ */
+class Board
+{
+public:
+
+    const Layout *layout;
+    int dim;
+    int cells;
+    size_t bytes;
+    char *data;
+
+    // views into data
+    mask_t *cand;
+    mask_t *used;
+    int8_t *val;
+
+    // undo log, not part of the copied state
+    Trail *trail;
+
+    // Constructors
+    Board();
+    Board(int n);
+    Board(const Board &other);
+    Board(Board &&other);
+    // Destructor
+    ~Board();
+
+    Board& operator=(const Board &other);
+    Board& operator=(Board &&other);
+
+    // sets candidates and used values from the current values
+    void init_candidates();
+
+    // places a value into an empty cell
+    void assign(int c, int v);
+
+    // copies the state to or from a block of bytes, e.g. from a BoardPool
+    void save(char *block) const;
+    void load(const char *block);
+
+    // overwrites the candidates of a cell
+    void set_cand(int c, mask_t m)
+    {
+        if(trail)
+            trail->record(c, cand[c]);
+        cand[c] = m;
+    }
+
+private:
+    void allocate(const Layout *l);
+    void release();
+};
+
+
+/*
+ * Deduction tactics known to the Propagator. Naked and hidden singles are
+ * always applied; the others are optional and are turned on with the bit
+ * (1 << tactic) in Propagator::tactics.
+ */
+enum Tactic
+{
+    NAKED_SINGLE,
+    HIDDEN_SINGLE,
+    NAKED_PAIR,
+    NAKED_TRIPLE,
+    NAKED_QUAD,
+    HIDDEN_PAIR,
+    HIDDEN_TRIPLE,
+    HIDDEN_QUAD,
+    POINTING,
+    BOX_LINE,
+    X_WING,
+    SWORDFISH,
+    NUM_TACTICS
+};
+
+#define TACTICS_ALL (((1 << NUM_TACTICS) - 1) & ~((1 << NAKED_SINGLE) | \
+                                                  (1 << HIDDEN_SINGLE)))
+
+
+/*
+ * Stats counts what a search did. Every solver and every deque of a
+ * WorkStealer updates its own copy without locking, and the copies are
+ * merged once the search is over. The counters are only touched through the
+ * STAT_ macros below, which compile to nothing when built with NO_STATS
+ * (make STATS=0).
+ */
+struct Stats
+{
+    // search tree
+    long nodes;         // tiles branched on
+    long guesses;       // values tried at those tiles
+    long backtracks;    // guesses that led to a contradiction
+    long max_depth;     // most guesses in effect at once
+    // propagation
+    long propagations;  // calls to Propagator.propagate()
+    long groups;        // groups taken off the worklist
+    // work stealing
+    long pushes;
+    long pops;
+    long steals;        // pops from another thread's deque
+    long peak_queue;    // most items in one deque at once
+    long wait_ns;       // spent acquiring deque locks and parked
+    // cancellation
+    long quiesce_ns;    // copied from the engine's quiesce_ns
+
+    Stats() { clear(); }
+    void clear();
+    void merge(const Stats &other);
+    void print_json(FILE *out, const char *engine, int threads,
+                    double seconds, const long *tactic_counts) const;
+};
+
+#ifdef NO_STATS
+#define STAT_ADD(s, field, n) do {} while(0)
+#define STAT_MAX(s, field, v) do {} while(0)
+#define STAT_CLOCK(start)
+#define STAT_WAIT(s, start) do {} while(0)
+#else
+#define STAT_ADD(s, field, n) ((s).field += (n))
+#define STAT_MAX(s, field, v) \
+    do { if((long)(v) > (s).field) (s).field = (long)(v); } while(0)
+#define STAT_CLOCK(start) uint64_t start = ReadClock()
+#define STAT_WAIT(s, start) ((s).wait_ns += ReadClock() - (start))
+#endif
+
+
+/*
+ * Propagator applies the elimination and lone_ranger tactics to a Board.
+ * Instead of sweeping all 3 * dim groups until nothing changes, it keeps a
+ * worklist of the groups touched by an assignment or a domain reduction and
+ * runs until the worklist is empty. Once it is empty, the optional tactics
+ * are tried over the whole board, and any reduction they make goes back on
+ * the worklist. A Propagator is not shared between threads.
+ *
+ * On boards of at least sweep_dim, outside a parallel region, a worklist of
+ * dim or more groups is instead swept by the whole OpenMP team, see
+ * sweep().
+ */
+class Propagator
+{
+public:
+
+    const Layout *layout;
+    // ring buffer of group indices waiting to be processed
+    vector<int> queue;
+    vector<char> queued;
+    int head;
+    int count;
+
+    // optional tactics turned on, and how often each tactic made progress
+    int tactics;
+    long counts[NUM_TACTICS];
+    // candidates removed so far, to tell whether a tactic did anything
+    long changes;
+    // propagation rounds and groups visited
+    Stats stats;
+    // when set, propagation gives up as soon as it becomes nonzero
+    const atomic<int> *stop;
+    // scratch of sweep(): reduced candidates, the groups swept, and
+    // the cells narrowed to one value by lone_ranger
+    vector<mask_t> domain;
+    vector<int> batch;
+    vector<char> lone_cell;
+
+    // tactics given to every new Propagator, set from the command line
+    static int default_tactics;
+    static const char *tactic_names[NUM_TACTICS];
+    // smallest dimension propagated on all threads
+    static int sweep_dim;
+
+    // Constructor
+    Propagator();
+
+    // full propagation of a board, returns 0 on a contradiction
+    int propagate(Board &board);
+    // place one value and propagate its consequences
+    int propagate(Board &board, int c, int v);
+
+    // tactics, applied to a single group
+    int elimination(Board &board, int g);
+    int lone_ranger(Board &board, int g);
+
+    // optional tactics, applied to the whole board
+    int advanced(Board &board);
+    int naked_subset(Board &board, int g, int n);
+    int hidden_subset(Board &board, int g, int n);
+    int intersection(Board &board, int g);
+    int fish(Board &board, int v, int n);
+
+    // counters
+    void merge(const Propagator &other);
+    void report(FILE *out);
+
+    // worklist helpers
+    int assign(Board &board, int c, int v);
+    int reduce(Board &board, int c, mask_t remove);
+    void push(int g);
+    int run(Board &board);
+    int sweep(Board &board);
+    void reset(const Board &board);
+};
+
+// parses a comma separated list of tactic names, -1 if a name is unknown
+int parse_tactics(const char *list);
+
+
+/*
+ * Symmetry is one of the moves that turn a puzzle into another with the
+ * same solutions moved alike: row i of the moved puzzle is row rows[i] of
+ * the puzzle (after the transpose), col j is col cols[j], and digit v is
+ * written as digits[v].
+ */
+struct Symmetry
+{
+    int transpose;
+    vector<int> rows;
+    vector<int> cols;
+    vector<int> digits;
+};
+
+// least form of a puzzle under every symmetry, see cache.cc
+int canonical_form(const int8_t *val, int dim, long limit, Symmetry &sym,
+                   string &key);
+
+
+/*
+ * SolveCache holds the solutions of recent puzzles, keyed by canonical
+ * form, so a puzzle that is a relabeling, transpose, or row and col
+ * shuffle of one solved before is not solved again. It is bounded, least
+ * recently used entries go first, and every thread may use it at once.
+ */
+class SolveCache
+{
+public:
+
+    struct Shard;
+    Shard *shards;
+    // entries all shards may hold together
+    size_t capacity;
+
+    atomic<long> hits;
+    atomic<long> misses;
+    // puzzles with too many ties to put in canonical form
+    atomic<long> skipped;
+
+    // Constructor
+    SolveCache(size_t entries);
+    // Destructor
+    ~SolveCache();
+
+    int lookup(Board &board, Symmetry &sym, string &key);
+    void insert(const Board &solution, const Symmetry &sym,
+                const string &key);
+    void report(FILE *out);
+
+private:
+    SolveCache(const SolveCache &);
+    SolveCache& operator=(const SolveCache &);
+};
+
+
 class Sudoku
 {
 public:
 
 	// variables 
-	vector<vector<Tile*>> matrix;
+	Board board;
+	const Layout *layout;
 	int dim;
 	int nonet;
-	vector<vector<Tile*>> groups;
-	vector<int> choices;
+	mask_t choices;
+	Propagator engine;
+
+	// explicit guess and check stack, one frame per guessed tile
+	struct Frame
+	{
+	    int cell;
+	    mask_t options;
+	    size_t marker;
+	};
+	vector<Frame> frames;
+	Trail trail;
+	// search tree counters, see Stats
+	Stats stats;
+	// when set, the search gives up as soon as it becomes nonzero
+	const atomic<int> *stop;
+	// guesses enumerate() may make before giving up, 0 for no limit
+	long budget;
+	// when set, each tile's candidates are guessed in random order
+	mt19937_64 *rng;
+	// when set, solve() looks the puzzle up first and caches its solution
+	SolveCache *cache;
+	Symmetry symmetry;
+	string cache_key;
 
 	// Constructor
-	Sudoku(vector<vector<Tile*>> in, int n);
+	Sudoku(const Board &in);
 	// Destructor
 	~Sudoku();
 
     // driver for solver
     // uses recursive guess and check and tactics
     int solve();
+    int search();
+
+    // counts solutions, stopping at limit (0 for no limit)
+    // limit 2 tells whether the solution is unique
+    // -1 if the budget ran out first
+    long count(long limit);
+    long enumerate(long limit);
 
     // propagate is the driver function for our two 
     // tactics, lone_ranger and elimination
-    void propagate();
-    int elimination();
-    int lone_ranger();
+    // both return 0 if the puzzle can no longer be solved
+    int propagate();
+    int propagate(int c, int v);
 
 
     // find optimal tile to make guesses for
-    Tile* min_choice_tile();
-
-    // for saving and restore state of the puzzle
-    // when incorrect guesses are made during
-    // the recursive guess and check
-    vector<vector<int>> as_list();
-    vector<vector<vector<int>>> candidates_list();
-    void restore_values(vector<vector<int>> value_list);
-    void restore_candidates(vector<vector<vector<int>>> candidate_list);
-
-    // helper functions for initiating the puzzle
-	vector<Tile*> get_row(int row);
-	vector<Tile*> get_col(int col);
-	vector<Tile*> get_nonet(int nonet);
+    // returns a cell index, or -1 if there are no empty cells
+    // the static one works on any board without copying it
+    int min_choice_tile();
+    static int min_choice_tile(const Board &puzzle);
 
     // ease of use helper functions
     void print();
-    int in(int val, vector<int> list);
     int is_valid(int &return_status);
     int is_complete();
 };
 
+/*
+ * WorkStealer is the scheduler behind Parallel::solve(). Every thread owns a
+ * deque of work items: the owner pushes and pops at the back (depth first),
+ * and idle threads steal from the front of other deques (the oldest, and
+ * usually largest, subtrees). A thread that finds no work parks instead of
+ * leaving, and only returns once no item is queued or being worked on
+ * anywhere, or the search has been stopped.
+ *
+ * Usage: pop() an item, push() any items it creates, then call done().
+ *
+ * Each deque is a ring buffer that doubles when full, so once a search has
+ * reached its widest point pushing and popping no longer allocate.
+ */
+template <class T>
+class WorkStealer
+{
+public:
+
+    struct Deque
+    {
+        omp_lock_t lock;
+        // ring buffer, size is a power of two
+        vector<T> items;
+        size_t head;
+        size_t count;
+        // only updated by the thread owning the deque
+        Stats stats;
+        // keep neighbouring deques off each other's cache lines
+        char pad[64];
+    };
+
+    int threads;
+    vector<Deque*> deques;
+
+    // items queued or being worked on, the search is over at 0
+    atomic<long> pending;
+    atomic<int> stop;
+
+    // parking for idle threads, epoch changes on every push
+    atomic<unsigned long> epoch;
+    atomic<int> idle;
+    mutex park_lock;
+    condition_variable park;
+
+    WorkStealer(int n)
+        : threads(n), pending(0), stop(0), epoch(0), idle(0)
+    {
+        for(int i = 0; i < threads; i++)
+        {
+            Deque *d = new Deque();
+            omp_init_lock(&d->lock);
+            d->items.resize(1024);
+            d->head = 0;
+            d->count = 0;
+            deques.push_back(d);
+        }
+    }
+
+    ~WorkStealer()
+    {
+        for(int i = 0; i < threads; i++)
+        {
+            omp_destroy_lock(&deques[i]->lock);
+            delete deques[i];
+        }
+    }
+
+    // adds an item to the back of a thread's deque
+    void push(int tid, T &&item)
+    {
+        pending++;
+        Deque *d = deques[tid];
+        STAT_CLOCK(start);
+        omp_set_lock(&d->lock);
+        STAT_WAIT(d->stats, start);
+        size_t size = d->items.size();
+        if(d->count == size)
+        {
+            // unroll the ring into one twice as large
+            vector<T> grown(size * 2);
+            for(size_t i = 0; i < size; i++)
+                grown[i] = std::move(d->items[(d->head + i) & (size - 1)]);
+            d->items.swap(grown);
+            d->head = 0;
+            size *= 2;
+        }
+        d->items[(d->head + d->count) & (size - 1)] = std::move(item);
+        d->count++;
+        STAT_ADD(d->stats, pushes, 1);
+        STAT_MAX(d->stats, peak_queue, d->count);
+        omp_unset_lock(&d->lock);
+
+        epoch++;
+        if(idle > 0)
+            wake(0);
+    }
+
+    // the item popped by a thread has been fully expanded
+    void done()
+    {
+        if(--pending == 0)
+            wake(1);
+    }
+
+    // ends the search, every thread returns from pop()
+    void cancel()
+    {
+        stop = 1;
+        wake(1);
+    }
+
+    /*
+     * pop()
+     *          Description: Takes the newest item from the thread's own
+     *                       deque, or steals the oldest item of another
+     *                       thread. Parks while there is nothing to take but
+     *                       other threads may still push work.
+     *          Input: tid -> thread number
+     *                 item -> filled in with the work item
+     *          Output: returns 1 if an item was taken, 0 once the search is
+     *                  over
+     *          Calls: take()
+     */
+    int pop(int tid, T &item)
+    {
+        int spins = 0;
+        while(!stop)
+        {
+            unsigned long seen = epoch;
+            if(take(tid, tid, item))
+                return 1;
+            for(int i = 1; i < threads; i++)
+            {
+                if(take(tid, (tid + i) % threads, item))
+                    return 1;
+            }
+
+            if(pending == 0)
+                return 0;
+
+            // spin a little before parking, work usually shows up soon
+            if(++spins < 64)
+            {
+                sched_yield();
+                continue;
+            }
+
+            STAT_CLOCK(parked);
+            unique_lock<mutex> guard(park_lock);
+            idle++;
+            park.wait(guard, [&]{
+                return epoch != seen || pending == 0 || stop;
+            });
+            idle--;
+            spins = 0;
+            STAT_WAIT(deques[tid]->stats, parked);
+        }
+        return 0;
+    }
+
+    // adds up the counters of every deque, once the search is over
+    void collect(Stats &into) const
+    {
+        for(int i = 0; i < threads; i++)
+            into.merge(deques[i]->stats);
+    }
+
+private:
+
+    // a thread's own deque is popped at the back, others at the front
+    int take(int tid, int victim, T &item)
+    {
+        Deque *d = deques[victim];
+        int steal = victim != tid;
+        int found = 0;
+        STAT_CLOCK(start);
+        omp_set_lock(&d->lock);
+        STAT_WAIT(deques[tid]->stats, start);
+        if(d->count)
+        {
+            size_t mask = d->items.size() - 1;
+            if(steal)
+            {
+                item = std::move(d->items[d->head]);
+                d->head = (d->head + 1) & mask;
+            }
+            else
+                item = std::move(d->items[(d->head + d->count - 1) & mask]);
+            d->count--;
+            found = 1;
+            STAT_ADD(deques[tid]->stats, pops, 1);
+            STAT_ADD(deques[tid]->stats, steals, steal);
+        }
+        omp_unset_lock(&d->lock);
+        return found;
+    }
+
+    void wake(int all)
+    {
+        // taking the lock orders this wake after a parker's last check
+        park_lock.lock();
+        park_lock.unlock();
+        if(all)
+            park.notify_all();
+        else
+            park.notify_one();
+    }
+};
+
+
+/*
+ * BoardPool hands out fixed size blocks for saved board states. Every
+ * thread of the parallel search owns one, blocks are recycled through a free
+ * list, and memory is mapped in chunks of at least 2MB, optionally backed by
+ * huge pages. A pool is not shared between threads.
+ */
+class BoardPool
+{
+public:
+
+    size_t block;
+    // mapped chunks, and returned blocks, each linked through their first
+    // bytes
+    char *chunks;
+    char *free_list;
+    // part of the newest chunk not handed out yet
+    char *next;
+    char *end;
+    size_t mapped;
+
+    // set from the command line to back new chunks with huge pages
+    static int huge_pages;
+
+    // Constructor
+    BoardPool(size_t bytes);
+    // Destructor
+    ~BoardPool();
+
+    char* get();
+    void put(char *p);
+    void reset();
+
+private:
+    void grow();
+};
+
+
+/*
+ * Branch is one work item of the parallel search: a saved board and the
+ * guess to propagate on it.
+ */
+struct Branch
+{
+    char *state;
+    int cell;
+    int val;
+    // guesses made to reach this one, for Stats.max_depth
+    int depth;
+};
+
+
 class Parallel
 {
 public:
     //variables
-    vector<vector<Tile*>> matrix;
+    Board board;
+    const Layout *layout;
     int dim;
     int nonet;
-    vector<vector<Tile*>> groups;
-    vector<int> choices;
+    mask_t choices;
+    Propagator engine;
+    // counters of every thread and deque, merged by solve()
+    Stats stats;
+    // from the limit being reached to every thread idle, measured
+    // even without stats, 0 if the search ran to the end
+    long quiesce_ns;
 
     // Constructor
-    Parallel(vector<vector<Tile*>> in, int n);
+    Parallel(const Board &in);
     // Destructor
     ~Parallel();
 
@@ -135,33 +810,447 @@ public:
     // guess and check
     void solve();
 
-    // used to create copy of the puzzle for threads to use
-    vector<vector<Tile*>> copy_matrix(vector<vector<Tile*>> input);
-    vector<vector<Tile*>> group_create(vector<vector<Tile*>> cpy_matrix);
+    // counts solutions across threads, stopping at limit (0 for no limit)
+    long count(long limit);
+
+    // used to save a copy of the puzzle for threads to use
+    char* copy_matrix(const Board &input, BoardPool &pool);
 
     // to store solved puzzle in class variables
-    void restore(const vector<vector<Tile*>>& solved);
+    void restore(const Board &solved);
 
     // to find optimal tile to make guesses for
-    Tile* min_choice_tile(vector<vector<Tile*>> puzzle);
-    Tile* min_choice_tile_row(int row);
+    int min_choice_tile(const Board &puzzle);
 
     // propagate is the driver function for our two 
     // tactics, lone_ranger and elimination
-    void propagate(vector<vector<Tile*>> &input);
-    int lone_ranger(vector<vector<Tile*>> &input);
-    int elimination(vector<vector<Tile*>> &input);
-
-    // functions for puzzle initialization
-    vector<Tile*> get_row(vector<vector<Tile*>> input, int row);
-    vector<Tile*> get_col(vector<vector<Tile*>> input, int col);
-    vector<Tile*> get_nonet(vector<vector<Tile*>> input, int nonet);
+    int propagate(Board &input);
 
     // ease of use helper functions
     void print();
-    int in(int val, vector<int> list);
     int is_valid(int &return_status);
     int is_complete();
 };
 
-#endif
\ No newline at end of file
+/*
+ * TaskSearch solves a puzzle in parallel by running the recursive guess and
+ * check of Sudoku as OpenMP tasks, one task per guess down to a cutoff and
+ * a serial search in place below it, see tasks.cc.
+ */
+class TaskSearch
+{
+public:
+
+    Board board;
+    const Layout *layout;
+    int dim;
+    Propagator engine;
+    // counters of every thread's solver, merged by solve()
+    Stats stats;
+
+    // a solver for every thread, each searching in place
+    vector<Sudoku*> solvers;
+    // set once a solution is found, the first of them
+    atomic<int> stop;
+    Board first;
+    // ReadClock() when the first solution was found, and the time
+    // from then to every thread idle, measured even without stats
+    uint64_t stopped_at;
+    long quiesce_ns;
+
+    // guesses deeper than cutoff, or on boards with fewer than
+    // min_empty empty squares, are searched serially
+    int cutoff;
+    int min_empty;
+    // tasks made
+    atomic<long> tasks;
+
+    // Constructor
+    TaskSearch(const Board &in);
+    // Destructor
+    ~TaskSearch();
+
+    int solve();
+    void print();
+
+    // helper functions
+    void expand(const Board &state, int cell, int depth);
+    int guess(const Board &state, int cell, int v, int depth);
+    int found(const Board &solution);
+};
+
+
+/*
+ * DLX solves a puzzle as an exact cover problem with Knuth's Algorithm X on
+ * dancing links. Every (cell, value) pair is a row covering four columns:
+ * the cell, the value in its row, the value in its col, and the value in its
+ * nonet. The nodes live in flat index arrays instead of linked objects.
+ */
+class DLX
+{
+public:
+
+    // variables
+    Board board;
+    const Layout *layout;
+    int dim;
+    int columns;
+
+    // node links, node 0 is the root and 1..columns are the column headers
+    vector<int> left;
+    vector<int> right;
+    vector<int> up;
+    vector<int> down;
+    vector<int> column;
+    // candidate row of each node, row = cell * dim + value - 1
+    vector<int> row;
+    // number of nodes left in each column
+    vector<int> size;
+
+    // rows chosen so far, one per level of the search
+    vector<int> chosen;
+    long solutions;
+    // search tree counters, see Stats
+    Stats stats;
+
+    // Constructor
+    DLX(const Board &in);
+
+    // driver for solver, stops after limit solutions (0 for no limit)
+    // the first solution found is left in board
+    long solve(long limit);
+
+    // ease of use helper functions
+    void print();
+
+private:
+    void build();
+    void add_row(int cell, int value);
+    int choose_column();
+    void cover(int c);
+    void uncover(int c);
+    void record();
+};
+
+
+/*
+ * PuzzleView points at one puzzle inside a PuzzleReader's buffer. Row r
+ * starts at data + r * stride; a one line puzzle has stride == dim. A
+ * puzzle of numbers has no stride, its len characters are decoded as one
+ * run of text. A packed puzzle is the len bytes of its record.
+ */
+struct PuzzleView
+{
+    const char *data;
+    size_t len;
+    int dim;
+    int stride;
+    int numeric;
+    int packed;
+};
+
+
+/*
+ * Header of a packed puzzle file, see packed.cc. Every record of the file
+ * has the same size, so record i is at sizeof(PackedHeader) + i * record.
+ */
+#define PACKED_VERSION 1
+// each record is followed by a bitmap of the cells that were givens
+#define PACKED_GIVENS 1
+extern const char packed_magic[4];
+
+struct PackedHeader
+{
+    char magic[4];
+    uint8_t version;
+    uint8_t dim;
+    uint8_t box_rows;
+    uint8_t box_cols;
+    uint8_t bits;
+    uint8_t flags;
+    uint16_t reserved;
+    uint32_t record;
+    uint64_t count;
+};
+
+
+/*
+ * PackedWriter writes puzzles or solutions as a packed file, records are
+ * packed by the caller with pack_cells() so that threads can fill a chunk
+ * of them at once.
+ */
+class PackedWriter
+{
+public:
+
+    FILE *out;
+    PackedHeader header;
+
+    // Constructor
+    PackedWriter();
+    // Destructor
+    ~PackedWriter();
+
+    int create(const char *file, int dim, int flags);
+    void write(const uint8_t *records, long n);
+    void close();
+};
+
+
+/*
+ * PuzzleReader parses puzzle files without copying them. Regular files are
+ * memory mapped, pipes are read in blocks. Views handed out by next() stay
+ * valid until release() is called. A mapped file starting with a packed
+ * header is read record by record instead of as text.
+ */
+class PuzzleReader
+{
+public:
+
+    int fd;
+    char *map;
+    size_t map_len;
+
+    // current buffer, the mapping or the newest block read
+    char *buf;
+    size_t len;
+    size_t pos;
+    // start of the puzzle being parsed, kept when a block is replaced
+    size_t mark;
+    int eof;
+    vector<char*> retired;
+
+    // set when the file is a mapped packed file
+    int packed;
+    PackedHeader header;
+
+    // Constructor
+    PuzzleReader();
+    // Destructor
+    ~PuzzleReader();
+
+    int open(const char *file);
+    void close();
+    int next(PuzzleView &view);
+    long skip(long n);
+    void release();
+    int decode(const PuzzleView &view, int8_t *val);
+
+private:
+    int refill();
+    int line(size_t &start, size_t &end);
+};
+
+
+/*
+ * Batch solves a whole file of puzzles with one puzzle per thread and
+ * writes one solution line per puzzle, in input order. When counting it
+ * writes how many solutions each puzzle has instead, and when packing one
+ * record per puzzle.
+ */
+class Batch
+{
+public:
+
+    PuzzleReader reader;
+    // puzzles of the chunk being solved and where their lines go
+    vector<PuzzleView> views;
+    vector<size_t> lines;
+
+    long solved;
+    long failed;
+    double seconds;
+    // tactic and search counters of every thread's solver
+    Propagator totals;
+    Stats stats;
+    // solve with solve_fixed() when there is one for the dimension
+    int fixed;
+    // write solution counts up to limit instead of solutions
+    int counting;
+    long limit;
+    // write a packed file to pack_file instead of lines
+    const char *pack_file;
+    PackedWriter writer;
+    // only convert the puzzles to the output format, do not solve them
+    int convert;
+    // solutions shared by every thread's solver, NULL for none
+    SolveCache *cache;
+
+    // Constructor
+    Batch();
+
+    int open(char *file);
+    int solve(FILE *out);
+    void summary(FILE *out);
+
+    // helper functions
+    int solve_one(const PuzzleView &view, Sudoku *&puzzle, char *out);
+    void retire(Sudoku *puzzle);
+};
+
+/*
+ * Difficulty of a generated puzzle, by the weakest deductions that solve it:
+ * naked singles only (elimination), singles (elimination and lone_ranger),
+ * the optional tactics, or guessing. GRADE_ANY accepts any of them.
+ */
+enum Grade
+{
+    GRADE_ANY,
+    GRADE_EASY,
+    GRADE_MEDIUM,
+    GRADE_HARD,
+    GRADE_EXPERT,
+    NUM_GRADES
+};
+
+extern const char *grade_names[NUM_GRADES];
+// parses a grade name, -1 if it is unknown
+int parse_grade(const char *name);
+
+
+/*
+ * Generator makes puzzles with a unique solution. Each thread shuffles a
+ * full grid and removes clues in random order, putting a clue back when the
+ * puzzle would lose its unique solution or grow harder than the grade asked
+ * for. Puzzles are written one per line as they are made.
+ */
+class Generator
+{
+public:
+
+    int dim;
+    int grade;
+    unsigned long seed;
+
+    // puzzles made, grids thrown away, and how many of each grade
+    long made;
+    long rejected;
+    long graded[NUM_GRADES];
+    double seconds;
+
+    // Constructor
+    Generator(int n, int g, unsigned long s);
+
+    void generate(long count, FILE *out);
+    void summary(FILE *out);
+
+    // helper functions
+    void fill(Board &grid, Sudoku &maker, mt19937_64 &rng);
+    int carve(Board &puzzle, Sudoku &check, Sudoku &singles,
+              Sudoku &tactics, mt19937_64 &rng);
+    int rate(const Board &puzzle, Sudoku &singles, Sudoku &tactics);
+};
+
+
+/*
+ * Frames of the solver daemon, see server.cc. A frame is a FrameHeader and
+ * length more bytes: the text of one puzzle in a request, and a
+ * ReplyHeader followed by the text of the solution in a reply. The id of a
+ * request is chosen by the client and sent back with its reply.
+ */
+#define FRAME_LIMIT (1 << 20)
+
+struct FrameHeader
+{
+    uint32_t length;
+    uint32_t id;
+};
+
+struct ReplyHeader
+{
+    // SDK_SOLVED, SDK_NO_SOLUTION or SDK_BAD_PUZZLE, see sdksolver.h
+    int32_t status;
+    uint32_t reserved;
+    // nanoseconds in the solver, and from reading the request to the reply
+    uint64_t solve_ns;
+    uint64_t total_ns;
+};
+
+struct Connection;
+struct Request;
+
+
+/*
+ * Server stays resident and answers puzzles sent as frames on stdin or on
+ * a Unix domain socket. One thread reads every connection and queues the
+ * requests, the others each keep a solver alive and write a reply as soon
+ * as its puzzle is solved, so a client can have many requests in flight.
+ */
+class Server
+{
+public:
+
+    // listening socket and its path, -1 and NULL when serving stdin
+    int listen_fd;
+    const char *path;
+    vector<Connection*> connections;
+
+    // requests waiting for a solver, and spare ones to reuse
+    deque<Request*> queue;
+    vector<Request*> spare;
+    mutex queue_lock;
+    condition_variable ready;
+    int done;
+
+    // one solver per thread, rebuilt when the dimension changes
+    SolverContext context;
+    int fixed;
+    int workers;
+
+    atomic<long> served;
+    atomic<long> solved;
+    double seconds;
+
+    // Constructor
+    Server();
+    // Destructor
+    ~Server();
+
+    int open(const char *file);
+    void serve();
+    void summary(FILE *out);
+
+    // helper functions
+    void poll_input();
+    int read_frames(Connection *conn);
+    void work(int t);
+    void answer(int t, Request *request, vector<uint8_t> &values,
+                vector<char> &out);
+    void release(Connection *conn);
+};
+
+
+/* character codes used by puzzle files, see read_info() */
+int decode_value(char ch, int dim);
+char encode_value(int val, int dim);
+const int8_t* decode_table(int dim);
+int decode_cells(const char *src, int n, const int8_t *table, int8_t *val);
+int board_dim(size_t len);
+void line_puzzle(const char *text, size_t n, PuzzleView &view);
+
+/* whitespace separated numbers, the only format for boards larger than
+   TOKEN_DIM since the letters run out */
+#define TOKEN_DIM 25
+int token_width(int dim);
+int decode_tokens(const char *src, size_t len, int dim, int8_t *val);
+size_t encode_tokens(const int8_t *val, int n, int dim, char *out);
+
+/* packed records, see packed.cc */
+int packed_bits(int dim);
+size_t packed_record(int dim, int flags);
+void pack_cells(const int8_t *val, int dim, uint8_t *rec);
+void pack_givens(const int8_t *val, int dim, uint8_t *rec);
+int unpack_cells(const uint8_t *rec, int dim, int flags, int8_t *val);
+int packed_header(const char *data, size_t len, PackedHeader &header);
+
+/* scans over the candidate masks of one group, see simd.cc */
+void group_counts(const mask_t *cand, const int *group, int dim,
+                  mask_t &once, mask_t &twice);
+mask_t group_changed(const mask_t *cand, const int *group, int dim,
+                     mask_t used);
+
+/* serial solvers compiled for each box size, see fixed.h */
+int fixed_supported(int dim);
+int solve_fixed(Board &board);
+
+#endif
@@ -5,7 +5,7 @@
  *			listed in final report.
  *
  * Date Created: 11/8/2021
- * Last Modified: 11/30/2021
+ * Last Modified: 10/17/2026
  *
  * Description: Final project for CIS 431 at the University of Oregon Fall
  *				2021. Driver function for the implementation of a Parallel 
@@ -25,6 +25,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <getopt.h>
 #include <iostream>
 #include <vector>
 #include <set>
@@ -40,17 +41,10 @@ using namespace std;
 
 /* Functions */
 void usage(char *argv);
-void read_info(char *file, vector<vector<Tile*>>& matrix, int& dim);
+void read_info(char *file, Board& board, int& dim, long index);
 
 int main(int argc, char **argv)
 {
-	// check proper arguments
-	if(argc > 3)
-	{
-		usage(argv[0]);
-		return 0;
-	}
-
 	/* Note:
 	 * Only one option can be given.
 	 *
@@ -65,12 +59,47 @@ int main(int argc, char **argv)
 	/* add boolean here */
 	int serial = 0;
     int parallel = 0;
+    int tasks = 0;
+    int batch = 0;
+    int dlx = 0;
+    int all = 0;
+    int tactics = 0;
+    int huge = 0;
+    int fixed = 0;
+    int stats = 0;
+    int phases = 0;
+    int counting = 0;
+    int unique = 0;
+    long limit = 0;
+    long generate = 0;
+    int size = 9;
+    int grade = GRADE_ANY;
+    unsigned long seed = ReadClock();
+    const char *pack_file = NULL;
+    int convert = 0;
+    long index = 0;
+    int serve = 0;
+    long cache_size = 0;
+
+	/* long options, no short flag of their own */
+	static struct option long_flags[] = {
+		{"stats", optional_argument, NULL, 'S'},
+		{"phases", no_argument, NULL, 'P'},
+		{"seed", required_argument, NULL, 'R'},
+		{"pack", required_argument, NULL, 'K'},
+		{"convert", no_argument, NULL, 'C'},
+		{"index", required_argument, NULL, 'I'},
+		{"serve", no_argument, NULL, 'V'},
+		{"cache", required_argument, NULL, 'Q'},
+		{NULL, 0, NULL, 0}
+	};
 
 	int flag;
 	opterr = 0;
 
 	/* add flag to string */
-	while((flag = getopt(argc, argv, "sp")) != -1)
+	while((flag = getopt_long(argc, argv, "spkbdfat:Hc:ug:n:l:", long_flags,
+	                          NULL)) != -1)
 	{
 		switch(flag)
 		{
@@ -81,6 +110,132 @@ int main(int argc, char **argv)
 
             case 'p':
                 parallel = 1;
+                break;
+
+            case 'k':
+                tasks = 1;
+                break;
+
+            case 'b':
+                batch = 1;
+                break;
+
+            case 'd':
+                dlx = 1;
+                break;
+
+            case 'f':
+                fixed = 1;
+                break;
+
+            case 'a':
+                all = 1;
+                break;
+
+            case 'H':
+                huge = 1;
+                break;
+
+            case 'c':
+                counting = 1;
+                limit = atol(optarg);
+                if(limit < 0 || optarg[strspn(optarg, "0123456789")])
+                {
+                    cerr << "Bad solution limit " << optarg << endl;
+                    usage(argv[0]);
+                    return 0;
+                }
+                break;
+
+            case 'u':
+                counting = 1;
+                unique = 1;
+                limit = 2;
+                break;
+
+            case 'g':
+                generate = atol(optarg);
+                if(generate < 1)
+                {
+                    cerr << "Bad number of puzzles " << optarg << endl;
+                    usage(argv[0]);
+                    return 0;
+                }
+                break;
+
+            case 'n':
+                size = atoi(optarg);
+                break;
+
+            case 'l':
+                grade = parse_grade(optarg);
+                if(grade < 0)
+                {
+                    cerr << "Unknown grade " << optarg << endl;
+                    usage(argv[0]);
+                    return 0;
+                }
+                break;
+
+            case 'R':
+                seed = strtoul(optarg, NULL, 10);
+                break;
+
+            case 't':
+                tactics = parse_tactics(optarg);
+                if(tactics < 0)
+                {
+                    cerr << "Unknown tactic in " << optarg << endl;
+                    usage(argv[0]);
+                    return 0;
+                }
+                break;
+
+            case 'S':
+                // json is the only format so far
+                if(optarg && strcmp(optarg, "json") != 0)
+                {
+                    cerr << "Unknown stats format " << optarg << endl;
+                    usage(argv[0]);
+                    return 0;
+                }
+                stats = 1;
+                break;
+
+            case 'P':
+                phases = 1;
+                break;
+
+            case 'K':
+                pack_file = optarg;
+                break;
+
+            case 'C':
+                convert = 1;
+                break;
+
+            case 'I':
+                index = atol(optarg);
+                if(index < 0 || optarg[strspn(optarg, "0123456789")])
+                {
+                    cerr << "Bad puzzle index " << optarg << endl;
+                    usage(argv[0]);
+                    return 0;
+                }
+                break;
+
+            case 'V':
+                serve = 1;
+                break;
+
+            case 'Q':
+                cache_size = atol(optarg);
+                if(cache_size < 0 || optarg[strspn(optarg, "0123456789")])
+                {
+                    cerr << "Bad cache size " << optarg << endl;
+                    usage(argv[0]);
+                    return 0;
+                }
                 break;
 
 			case '?':
@@ -91,10 +246,109 @@ int main(int argc, char **argv)
 	}
 
 
+	// exactly one file after the options
+	if(optind != argc - 1)
+	{
+		usage(argv[0]);
+		return 0;
+	}
+
+	// optional tactics for every solver created from here on
+	Propagator::default_tactics = tactics;
+	BoardPool::huge_pages = huge;
+
+	// generator mode: the file is where the puzzles go
+	if(generate)
+	{
+		int box = sqrt(size);
+		if(size < 4 || size > MAX_DIM || box * box != size)
+		{
+			cerr << "Can not generate " << size << "x" << size << endl;
+			return 0;
+		}
+
+		FILE *out = stdout;
+		if(strcmp(argv[optind], "-") != 0)
+			out = fopen(argv[optind], "w");
+		if(out == NULL)
+		{
+			usage(argv[0]);
+			return 0;
+		}
+
+		Generator maker(size, grade, seed);
+		{
+			ScopedTimer timer(PHASE_SEARCH);
+			maker.generate(generate, out);
+		}
+		if(out != stdout)
+			fclose(out);
+		maker.summary(stderr);
+		if(phases)
+			ReportPhases(stderr);
+		return 1;
+	}
+
+	// server mode: the file is stdin or the socket to listen on
+	if(serve)
+	{
+		Server server;
+		server.fixed = fixed;
+		server.context.use_cache(cache_size);
+		if(!server.open(argv[optind]))
+		{
+			cerr << "Can not listen on " << argv[optind] << endl;
+			return 0;
+		}
+		server.serve();
+		server.summary(stderr);
+		return 1;
+	}
+
+	// batch mode: many puzzles, one solution line (or record) each,
+	// converting only rewrites the puzzles in the output format
+	// handled before the single puzzle timer is set up
+	if(batch || convert || pack_file)
+	{
+		SolveCache cache(cache_size);
+		Batch corpus;
+		corpus.fixed = fixed;
+		corpus.cache = cache_size ? &cache : NULL;
+		corpus.counting = counting;
+		corpus.limit = limit;
+		corpus.convert = convert;
+		corpus.pack_file = pack_file;
+		if(!corpus.open(argv[optind]))
+		{
+			usage(argv[0]);
+			return 0;
+		}
+		if(!corpus.solve(stdout))
+		{
+			cerr << "Can not write " << pack_file << endl;
+			return 0;
+		}
+		corpus.summary(stderr);
+		if(stats)
+		{
+			Stats total = corpus.stats;
+			total.merge(corpus.totals.stats);
+			total.print_json(stderr, fixed ? "batch_fixed" : "batch",
+			                 omp_get_max_threads(), corpus.seconds,
+			                 corpus.totals.counts);
+		}
+		if(phases)
+			ReportPhases(stderr);
+		return 1;
+	}
+
 	// read sudoku puzzle from file
-	vector<vector<Tile*>> matrix;
+	Board board;
 	int dim;
-	read_info(argv[2], matrix, dim);
+	{
+		ScopedTimer timer(PHASE_PARSE);
+		read_info(argv[optind], board, dim, index);
+	}
   	double perfect_square = sqrt(dim) - (int)sqrt(dim);
 
 	if(!dim || perfect_square)
@@ -104,20 +358,65 @@ int main(int argc, char **argv)
 	}
 
 
-	// initialize timer
-    InitTSC();
-    unsigned long start = ReadTSC();
-
-
 	/* add if statement for solving method here */
 	int return_value;
-	if(serial)
+	uint64_t start;
+	if(counting)
+	{
+		// count with the parallel solver with -p, serial otherwise
+		long found;
+		double seconds;
+		ScopedTimer timer(PHASE_INIT);
+		if(parallel)
+		{
+			Parallel puzzle(board);
+			start = ReadClock();
+			timer.next(PHASE_SEARCH);
+			found = puzzle.count(limit);
+			seconds = ElapsedTime(ReadClock() - start);
+			timer.next(PHASE_OUTPUT);
+			if(stats)
+				puzzle.stats.print_json(stderr, "parallel_count",
+				                        omp_get_max_threads(), seconds,
+				                        puzzle.engine.counts);
+			puzzle.print();
+		}
+		else
+		{
+			Sudoku puzzle(board);
+			start = ReadClock();
+			timer.next(PHASE_SEARCH);
+			found = puzzle.count(limit);
+			seconds = ElapsedTime(ReadClock() - start);
+			timer.next(PHASE_OUTPUT);
+			if(stats)
+			{
+				Stats total = puzzle.stats;
+				total.merge(puzzle.engine.stats);
+				total.print_json(stderr, "serial_count", 1, seconds,
+				                 puzzle.engine.counts);
+			}
+			puzzle.print();
+		}
+
+		cout << "Time to count: " << seconds << endl;
+		cout << "Solutions: " << found;
+		if(limit && found >= limit)
+			cout << " (stopped at the limit)";
+		cout << endl;
+		if(unique)
+			cout << "Unique: " << (found == 1 ? "yes" : "no") << endl;
+	}
+	else if(serial)
 	{
 		// init puzzle and print puzzle
-        Sudoku puzzle(matrix, dim);
+        ScopedTimer timer(PHASE_INIT);
+        Sudoku puzzle(board);
+        timer.next(PHASE_OUTPUT);
         puzzle.print();
 
         // check that input puzzle is vaild 
+        timer.next(PHASE_VERIFY);
         cout << "Checking valid puzzle...";
         int valid = puzzle.is_valid(return_value);
         if(!valid)
@@ -125,13 +424,30 @@ int main(int argc, char **argv)
         else
             cout << "success" << endl;
 
-        // solve
-        start = ReadTSC();
-		puzzle.solve();
-        cout << "Time to solve: " << ElapsedTime(ReadTSC() - start) << endl;
+        // solve, timing the first propagation apart from the search
+        start = ReadClock();
+        timer.next(PHASE_PROPAGATE);
+        if(puzzle.propagate())
+        {
+            timer.next(PHASE_SEARCH);
+            puzzle.search();
+        }
+        double seconds = ElapsedTime(ReadClock() - start);
+        timer.next(PHASE_OUTPUT);
+        cout << "Time to solve: " << seconds << endl;
+        if(tactics)
+            puzzle.engine.report(stdout);
+        if(stats)
+        {
+            Stats total = puzzle.stats;
+            total.merge(puzzle.engine.stats);
+            total.print_json(stderr, "serial", 1, seconds,
+                             puzzle.engine.counts);
+        }
 
         // print solved puzzle and check if valid
         puzzle.print();
+        timer.next(PHASE_VERIFY);
         cout << "Checking valid puzzle...";
         valid = puzzle.is_valid(return_value);
         if(!valid)
@@ -142,10 +458,13 @@ int main(int argc, char **argv)
     else if(parallel)
     {
     	// init puzzle and print
-        Parallel puzzle(matrix, dim);
+        ScopedTimer timer(PHASE_INIT);
+        Parallel puzzle(board);
+        timer.next(PHASE_OUTPUT);
         puzzle.print();
 
         // check that input is valid
+        timer.next(PHASE_VERIFY);
         cout << "Checking valid puzzle...";
         int valid = puzzle.is_valid(return_value);
         if(!valid)
@@ -153,22 +472,141 @@ int main(int argc, char **argv)
         else
             cout << "success" << endl;
 
-        // solve
-        start = ReadTSC();
+        // solve, solve() times its own first propagation
+        start = ReadClock();
+        timer.next(PHASE_SEARCH);
         puzzle.solve();
-        cout << "Time to solve: " << ElapsedTime(ReadTSC() - start) << endl;
+        double seconds = ElapsedTime(ReadClock() - start);
+        timer.next(PHASE_OUTPUT);
+        cout << "Time to solve: " << seconds << endl;
+        cout << "Time to stop: " << puzzle.quiesce_ns / 1e9 << endl;
+        if(tactics)
+            puzzle.engine.report(stdout);
+        if(stats)
+            puzzle.stats.print_json(stderr, "parallel",
+                                    omp_get_max_threads(), seconds,
+                                    puzzle.engine.counts);
 
         // print solution and one final check that its valid
         puzzle.print();
+        timer.next(PHASE_VERIFY);
         cout << "Checking valid puzzle...";
-        puzzle.is_valid(return_value);
         valid = puzzle.is_valid(return_value);
         if(!valid)
             cout << "failure" << endl;
         else
             cout << "success" << endl;
     }
+    else if(tasks)
+    {
+        // init puzzle and print
+        ScopedTimer timer(PHASE_INIT);
+        TaskSearch puzzle(board);
+        timer.next(PHASE_OUTPUT);
+        puzzle.print();
+
+        // check that input is valid
+        timer.next(PHASE_VERIFY);
+        cout << "Checking valid puzzle...";
+        int valid = Sudoku(puzzle.board).is_valid(return_value);
+        if(!valid)
+            cout << "failure" << endl;
+        else
+            cout << "success" << endl;
+
+        // solve, solve() times its own first propagation
+        start = ReadClock();
+        timer.next(PHASE_SEARCH);
+        int solved = puzzle.solve();
+        double seconds = ElapsedTime(ReadClock() - start);
+        timer.next(PHASE_OUTPUT);
+        cout << "Time to solve: " << seconds << endl;
+        cout << "Time to stop: " << puzzle.quiesce_ns / 1e9 << endl;
+        cout << "Tasks: " << puzzle.tasks << " cutoff: " << puzzle.cutoff
+             << endl;
+        if(tactics)
+            puzzle.engine.report(stdout);
+        if(stats)
+            puzzle.stats.print_json(stderr, "tasks", omp_get_max_threads(),
+                                    seconds, puzzle.engine.counts);
+
+        // print solution and one final check that its valid
+        puzzle.print();
+        timer.next(PHASE_VERIFY);
+        cout << "Checking valid puzzle...";
+        if(!solved || !Sudoku(puzzle.board).is_valid(return_value))
+            cout << "failure" << endl;
+        else
+            cout << "success" << endl;
+    }
+    else if(fixed)
+    {
+        if(!fixed_supported(dim))
+        {
+            cerr << "No specialized solver for " << dim << "x" << dim << endl;
+            return 0;
+        }
+
+        // init puzzle and print puzzle
+        ScopedTimer timer(PHASE_INIT);
+        Sudoku puzzle(board);
+        timer.next(PHASE_OUTPUT);
+        puzzle.print();
+
+        // solve with the solver compiled for this box size
+        start = ReadClock();
+        timer.next(PHASE_SEARCH);
+        int solved = solve_fixed(puzzle.board);
+        double seconds = ElapsedTime(ReadClock() - start);
+        timer.next(PHASE_OUTPUT);
+        cout << "Time to solve: " << seconds << endl;
+
+        // the specialized solvers keep no counters, only the time
+        if(stats)
+            Stats().print_json(stderr, "fixed", 1, seconds, NULL);
+
+        // print solved puzzle and check if valid
+        puzzle.print();
+        timer.next(PHASE_VERIFY);
+        cout << "Checking valid puzzle...";
+        if(!solved || !puzzle.is_valid(return_value))
+            cout << "failure" << endl;
+        else
+            cout << "success" << endl;
+    }
+    else if(dlx || all)
+    {
+        // init exact cover matrix and print
+        ScopedTimer timer(PHASE_INIT);
+        DLX puzzle(board);
+        timer.next(PHASE_OUTPUT);
+        puzzle.print();
 
+        // solve, counting every solution with -a
+        start = ReadClock();
+        timer.next(PHASE_SEARCH);
+        long found = puzzle.solve(all ? 0 : 1);
+        double seconds = ElapsedTime(ReadClock() - start);
+        timer.next(PHASE_OUTPUT);
+        cout << "Time to solve: " << seconds << endl;
+        if(all)
+            cout << "Solutions: " << found << endl;
+        if(stats)
+            puzzle.stats.print_json(stderr, "dlx", 1, seconds, NULL);
+
+        // print the first solution and check that its valid
+        puzzle.print();
+        timer.next(PHASE_VERIFY);
+        Sudoku check(puzzle.board);
+        cout << "Checking valid puzzle...";
+        if(!found || !check.is_valid(return_value))
+            cout << "failure" << endl;
+        else
+            cout << "success" << endl;
+    }
+
+	if(phases)
+		ReportPhases(stderr);
 	return 1;
 }
 
@@ -179,70 +617,94 @@ void usage(char *argv)
 	     << argv
 	     << " [OPTION]... [FILE]..."
 	     << endl;
+	cout << "  -s  solve one puzzle with the serial solver" << endl;
+	cout << "  -p  solve one puzzle with the parallel solver" << endl;
+	cout << "  -k  solve one puzzle with the parallel solver built on OpenMP"
+	     << " tasks" << endl;
+	cout << "  -b  solve every puzzle in the file, one per thread,"
+	     << " printing one line per puzzle" << endl;
+	cout << "  -f  solve one puzzle with the serial solver compiled for its"
+	     << " box size (up to 49x49)," << endl;
+	cout << "      with -b solve every puzzle with it" << endl;
+	cout << "  -d  solve one puzzle with the dancing links exact cover"
+	     << " solver" << endl;
+	cout << "  -a  count every solution of one puzzle with the dancing"
+	     << " links solver" << endl;
+	cout << "  -t  LIST  turn on optional tactics for -s, -p, -k and -b, a comma"
+	     << " separated list of" << endl;
+	cout << "      naked_pair, naked_triple, naked_quad, hidden_pair,"
+	     << " hidden_triple," << endl;
+	cout << "      hidden_quad, pointing, box_line, x_wing, swordfish,"
+	     << " or all" << endl;
+	cout << "  -H  back the boards saved by -p with huge pages" << endl;
+	cout << "  -c  LIMIT  count the solutions of one puzzle, in parallel with"
+	     << " -p, stopping" << endl;
+	cout << "      at LIMIT (0 for no limit). With -b write the count of"
+	     << " every puzzle" << endl;
+	cout << "  -u  check that the solution is unique, same as -c 2" << endl;
+	cout << "  -g  COUNT  generate COUNT puzzles with a unique solution into"
+	     << " FILE (- for stdout)" << endl;
+	cout << "  -n  DIM  dimension of generated puzzles (default 9)" << endl;
+	cout << "  -l  GRADE  grade of generated puzzles: easy, medium, hard,"
+	     << " expert, or any" << endl;
+	cout << "      (default any)" << endl;
+	cout << "  --seed=N  seed for -g, printed with the summary" << endl;
+	cout << "  --stats[=json]  print search counters for any mode as JSON"
+	     << " on stderr" << endl;
+	cout << "      (all 0 when built with make STATS=0)" << endl;
+	cout << "  --pack=OUT  write the solutions of -b to OUT as a packed"
+	     << " file, keeping which" << endl;
+	cout << "      cells were givens (- for stdout)" << endl;
+	cout << "  --convert  rewrite the puzzles of FILE without solving them,"
+	     << " as lines, or" << endl;
+	cout << "      packed into OUT with --pack" << endl;
+	cout << "  --index=N  solve puzzle N (from 0) of FILE instead of the"
+	     << " first one" << endl;
+	cout << "  --serve  stay running and solve puzzles sent as frames on"
+	     << " FILE: - for stdin," << endl;
+	cout << "      with the replies on stdout, or the path of a Unix domain"
+	     << " socket to" << endl;
+	cout << "      listen on (see server.cc). -f and -t apply" << endl;
+	cout << "  --cache=N  keep the solutions of the last N puzzles for -b and"
+	     << " --serve, and take" << endl;
+	cout << "      a puzzle's solution from there when it is a relabeling,"
+	     << " transpose, or" << endl;
+	cout << "      row and col shuffle of one of them (not with -f)" << endl;
+	cout << "  --phases  print the time spent parsing, setting up,"
+	     << " propagating, searching," << endl;
+	cout << "      verifying and printing on stderr" << endl;
+	cout << "FILE may also be a packed file written with --pack."
+	     << endl;
+	cout << "Cells are one character each, or whitespace separated numbers"
+	     << " (0 for empty)," << endl;
+	cout << "which boards larger than 25x25 must be written in."
+#ifdef WIDE_MASKS
+	     << " Boards go up to 121x121." << endl;
+#else
+	     << " Boards go up to 64x64," << endl;
+	cout << "or 121x121 when built with make WIDE=1." << endl;
+#endif
 }
 
-void read_info(char *file, vector<vector<Tile*>>& matrix, int& dim)
+void read_info(char *file, Board& board, int& dim, long index)
 {
 	dim = 0;
-	FILE *fp = fopen(file, "r");
-	if(fp != NULL)
-	{
-		// get dimension
-		fscanf(fp, "%d\n", &dim);
-
-		int line = 0;
-		size_t len = 2048;
-		char *buf = (char *)malloc(len);
-		while(getline(&buf, &len, fp) != -1)
-		{
-
-			// confirm row length == dim and that
-			// col length < dim
-			if(strlen(buf) - 1 != (long unsigned)dim || line > dim)
-			{
-				dim = 0;
-				break;
-			}
-
-			// get row values
-			vector<Tile*> tmp;
-			for(int i = 0; i < dim; i++)
-            {
-            	// create new tile, store values, put into puzzle
-            	// different methods for different inputs depending
-            	// upon if the puzzle is 9x9, 16x16 or 25x25
-                Tile *nnew = new Tile();
-				char num = tolower(buf[i]);
-				if(num == 46)
-				{
-					nnew->row = line;
-					nnew->col = i;
-					nnew->val = -1;
-				}
-				else
-				{
-					nnew->row = line;
-					nnew->col = i;
-					if(dim > 16)
-						nnew->val = (int)num - 96;
-					else if(dim == 16)
-					{
-						if(num > 96)
-							nnew->val = (int)(num - 86);
-						else
-							nnew->val = (int)(num - 47);
-					}
-					else
-						nnew->val = (int)(num - '0');
-				}
-                vector<int>work;
-                nnew->candidates = work;
-				tmp.push_back(nnew);
-			}
-			matrix.push_back(tmp);
-			line++;
-		}
-		free(buf);
-		fclose(fp);
-	}
+	PuzzleReader reader;
+	PuzzleView view;
+
+	// puzzle number index in the file, parsed in place
+	// a packed file goes straight to its record
+	if(!reader.open(file) || reader.skip(index) != index ||
+	   !reader.next(view) || !view.dim)
+		return;
+
+	// decode_table() handles the different characters used
+	// depending upon if the puzzle is 9x9, 16x16 or 25x25
+	board = Board(view.dim);
+	if(!reader.decode(view, board.val))
+		return;
+
+	// generate the candidates of every empty cell
+	dim = view.dim;
+	board.init_candidates();
 }
@@ -0,0 +1,278 @@
+/*
+ * Author: Luke Vandecasteele
+ *
+ * Credits: Matthew Trappert, Dr. Jee W. Choi, Class notes, and other sources
+ *          listed in final report.
+ *
+ * Date Created: 10/17/2026
+ * Last Modified: 10/17/2026
+ *
+ * Description: Final project for CIS 431 at the University of Oregon Fall
+ *              2021. The packed binary puzzle format: the bit packing of
+ *              records and the PackedWriter class that writes a file of
+ *              them. Packed files are read by PuzzleReader.
+ * Notes:
+ *       1. See header.h for all class methods and variables.
+ *       2. All methods contain headers for individual usage and description.
+ *       3. A file is a PackedHeader followed by count records of the same
+ *          size, so record i starts at sizeof(PackedHeader) + i * record.
+ *          The header is written as the cpu lays it out (little endian on
+ *          every machine this has been run on).
+ *       4. Cells are packed least significant bit first, bits per cell,
+ *          the value or 0 for an empty square. With PACKED_GIVENS the cells
+ *          are followed by a bitmap with bit c set when cell c was a given,
+ *          so a record holding a solution still knows its puzzle.
+ *
+ */
+
+#include <string.h>
+#include "header.h"
+
+const char packed_magic[4] = {'S', 'D', 'K', 'P'};
+
+/*
+ * packed_bits()
+ *          Description: Bits needed for one cell, enough for 0 to dim.
+ *          Input: dim -> dimension of the puzzle
+ *          Output: 4 for 9x9, 5 for 16x16 and 25x25, 6 for 36x36 and 49x49,
+ *                  7 up to 121x121
+ *          Calls: None
+ */
+
+int packed_bits(int dim)
+{
+    int bits = 1;
+    while((1 << bits) <= dim)
+        bits++;
+    return bits;
+}
+
+/*
+ * packed_record()
+ *          Description: Size of one record.
+ *          Input: dim -> dimension of the puzzle
+ *                 flags -> PACKED_GIVENS if records carry a givens bitmap
+ *          Output: size in bytes
+ *          Calls: packed_bits()
+ */
+
+size_t packed_record(int dim, int flags)
+{
+    size_t cells = (size_t)dim * dim;
+    size_t bytes = (cells * packed_bits(dim) + 7) / 8;
+    if(flags & PACKED_GIVENS)
+        bytes += (cells + 7) / 8;
+    return bytes;
+}
+
+/*
+ * pack_cells()
+ *          Description: Packs the values of a board into a record.
+ *          Input: val -> values, -1 for an empty square
+ *                 dim -> dimension of the puzzle
+ *                 rec -> record to fill, its givens bitmap is left alone
+ *          Output: None
+ *          Calls: packed_bits()
+ */
+
+void pack_cells(const int8_t *val, int dim, uint8_t *rec)
+{
+    int bits = packed_bits(dim);
+    int cells = dim * dim;
+    uint64_t acc = 0;
+    int have = 0;
+    for(int c = 0; c < cells; c++)
+    {
+        uint64_t v = val[c] == -1 ? 0 : val[c];
+        acc |= v << have;
+        have += bits;
+        while(have >= 8)
+        {
+            *rec++ = (uint8_t)acc;
+            acc >>= 8;
+            have -= 8;
+        }
+    }
+    if(have)
+        *rec = (uint8_t)acc;
+}
+
+/*
+ * pack_givens()
+ *          Description: Fills the givens bitmap of a record from a puzzle.
+ *          Input: val -> values of the puzzle, -1 for an empty square
+ *                 dim -> dimension of the puzzle
+ *                 rec -> record with room for PACKED_GIVENS
+ *          Output: None
+ *          Calls: packed_record()
+ */
+
+void pack_givens(const int8_t *val, int dim, uint8_t *rec)
+{
+    int cells = dim * dim;
+    uint8_t *map = rec + packed_record(dim, 0);
+    memset(map, 0, (cells + 7) / 8);
+    for(int c = 0; c < cells; c++)
+    {
+        if(val[c] != -1)
+            map[c >> 3] |= (uint8_t)(1 << (c & 7));
+    }
+}
+
+/*
+ * unpack_cells()
+ *          Description: Unpacks a record into the values of a board. With a
+ *                       givens bitmap only the givens are kept, giving back
+ *                       the puzzle the record was solved from.
+ *          Input: rec -> record to read
+ *                 dim -> dimension of the puzzle
+ *                 flags -> flags of the file
+ *                 val -> where to store dim * dim values
+ *          Output: returns 1 if every value was in range, 0 otherwise
+ *          Calls: packed_bits(), packed_record()
+ */
+
+int unpack_cells(const uint8_t *rec, int dim, int flags, int8_t *val)
+{
+    int bits = packed_bits(dim);
+    int cells = dim * dim;
+    uint64_t mask = (1 << bits) - 1;
+    const uint8_t *map = rec + packed_record(dim, 0);
+    uint64_t acc = 0;
+    int have = 0;
+    int bad = 0;
+    for(int c = 0; c < cells; c++)
+    {
+        while(have < bits)
+        {
+            acc |= (uint64_t)*rec++ << have;
+            have += 8;
+        }
+        int v = (int)(acc & mask);
+        acc >>= bits;
+        have -= bits;
+
+        if((flags & PACKED_GIVENS) && !((map[c >> 3] >> (c & 7)) & 1))
+            v = 0;
+        bad |= v > dim;
+        val[c] = v ? (int8_t)v : -1;
+    }
+    return !bad;
+}
+
+/*
+ * packed_header()
+ *          Description: Checks that a block starts with a valid header for
+ *                       this solver, i.e. square boxes and a dimension the
+ *                       masks can hold.
+ *          Input: data -> start of the file
+ *                 len -> bytes in the file
+ *                 header -> filled in with the header, count set to the
+ *                           number of records in the file
+ *          Output: returns 1 if the header is valid, 0 otherwise
+ *          Calls: board_dim(), packed_bits(), packed_record()
+ */
+
+int packed_header(const char *data, size_t len, PackedHeader &header)
+{
+    if(len < sizeof(PackedHeader))
+        return 0;
+    memcpy(&header, data, sizeof(PackedHeader));
+
+    int dim = header.dim;
+    if(memcmp(header.magic, packed_magic, 4) != 0 ||
+       header.version != PACKED_VERSION ||
+       !board_dim((size_t)dim * dim) ||
+       header.box_rows * header.box_rows != dim ||
+       header.box_cols != header.box_rows ||
+       header.bits != packed_bits(dim) ||
+       header.record != packed_record(dim, header.flags))
+        return 0;
+
+    // a writer that could not seek back (a pipe) leaves the count at 0
+    uint64_t count = (len - sizeof(PackedHeader)) / header.record;
+    if(header.count != 0 && header.count != count)
+        return 0;
+    header.count = count;
+    return 1;
+}
+
+// Constructor
+PackedWriter::PackedWriter()
+{
+    out = NULL;
+    memset(&header, 0, sizeof(header));
+}
+
+// Destructor
+PackedWriter::~PackedWriter()
+{
+    close();
+}
+
+/*
+ * create()
+ *          Description: Creates a packed file and writes its header. The
+ *                       count is filled in by close().
+ *          Input: file -> path of the file, "-" for stdout
+ *                 dim -> dimension of every puzzle in the file
+ *                 flags -> PACKED_GIVENS to keep a givens bitmap
+ *          Output: returns 1 on success, 0 if the file could not be created
+ *          Calls: packed_bits(), packed_record()
+ */
+
+int PackedWriter::create(const char *file, int dim, int flags)
+{
+    close();
+    out = strcmp(file, "-") == 0 ? stdout : fopen(file, "wb");
+    if(out == NULL)
+        return 0;
+
+    memcpy(header.magic, packed_magic, 4);
+    header.version = PACKED_VERSION;
+    header.dim = (uint8_t)dim;
+    header.box_rows = header.box_cols = (uint8_t)sqrt((double)dim);
+    header.bits = (uint8_t)packed_bits(dim);
+    header.flags = (uint8_t)flags;
+    header.reserved = 0;
+    header.record = (uint32_t)packed_record(dim, flags);
+    header.count = 0;
+    return fwrite(&header, sizeof(header), 1, out) == 1;
+}
+
+/*
+ * write()
+ *          Description: Appends records packed by pack_cells().
+ *          Input: records -> n records, one after another
+ *                 n -> number of records
+ *          Output: None
+ *          Calls: None
+ */
+
+void PackedWriter::write(const uint8_t *records, long n)
+{
+    fwrite(records, header.record, n, out);
+    header.count += n;
+}
+
+/*
+ * close()
+ *          Description: Writes the final count into the header, when the
+ *                       file can be seeked, and closes it.
+ *          Input: None
+ *          Output: None
+ *          Calls: None
+ */
+
+void PackedWriter::close()
+{
+    if(out == NULL)
+        return;
+    if(fseek(out, 0, SEEK_SET) == 0)
+        fwrite(&header, sizeof(header), 1, out);
+    if(out == stdout)
+        fflush(out);
+    else
+        fclose(out);
+    out = NULL;
+}
@@ -5,51 +5,33 @@
  *          listed in final report.
  *
  * Date Created: 11/8/2021
- * Last Modified: 12/2/2021
+ * Last Modified: 10/17/2026
  *
  * Description: Final project for CIS 431 at the University of Oregon Fall
  *              2021. Implementation of a parallel sudoku solver. 
  * Notes: 
  *       1. See header.h for all class methods and variables.
  *       2. All methods contain headers for individual usage and description.
+ *       3. The search is stopped with the WorkStealer's flag rather than
+ *          omp cancel, which does nothing unless OMP_CANCELLATION=true. The
+ *          threads' propagation checks the same flag, so no thread is left
+ *          finishing a guess once the limit is reached.
  *
  */
 
 #include "header.h"
 
 // Constructor
-Parallel::Parallel(vector<vector<Tile*>> in, int n)
+Parallel::Parallel(const Board &in)
+    : board(in)
 {
-    matrix = in;
-    dim = n;
-    nonet = sqrt(n);
-
+    layout = board.layout;
+    dim = board.dim;
+    nonet = layout->nonet;
 
     // set possible candidates for the puzzle
-    for(int i = 1; i <= dim; i++) choices.push_back(i);
-
-    // generate candidates for each tile
-    for(int i = 0; i < dim; i++)
-    {
-        for(int j = 0; j < dim; j++)
-        {
-            matrix[i][j]->gen_candidates(choices);
-        }
-    }
-
-    // generate groups
-    for(int i = 0; i < dim; i++)
-    {
-        vector<Tile*> tmp = get_row(matrix, i);
-        groups.push_back(tmp);
-
-        tmp = get_col(matrix, i);
-        groups.push_back(tmp);
-
-        tmp = get_nonet(matrix, i);
-        groups.push_back(tmp);
-
-    }
+    choices = mask_all(dim);
+    quiesce_ns = 0;
 }
 
 // Destructor
@@ -57,7 +39,7 @@ Parallel::~Parallel()
 {
     /* 
      * do nothing
-     * vector will be cleaned up automatically by its destructor 
+     * board will be cleaned up automatically by its destructor 
      */
 }
 
@@ -65,124 +47,159 @@ Parallel::~Parallel()
  *  solve()
  *          Description: Driver for a parallel sudoku solver. Uses a
  *                       combination of lone_ranger() and elimination() tactics
- *                       as well as a parallel guess and check algorithm.
+ *                       as well as a parallel guess and check algorithm,
+ *                       stopping at the first solution.
  *          Input: None
  *          Output: None
- *          Calls: propagate(), is_complete(), is_valid(), and Tile class
- *                 methods. 
+ *          Calls: count()
  */
 
 void Parallel::solve()
 {
     cout << "Parallel method...";
+    count(1);
+    cout << "done" << endl;
+}
 
+/*
+ *  count()
+ *          Description: Parallel guess and check that counts solutions.
+ *                       Guesses are scheduled with a WorkStealer, so
+ *                       threads keep working from their own deque and only
+ *                       stop once every guess has been checked or limit
+ *                       solutions have been found. Each guess carries the
+ *                       board it was made on, saved in a block from the
+ *                       pushing thread's BoardPool. Solutions are counted
+ *                       per thread, only a limited count is shared while
+ *                       searching. The first solution is claimed with an
+ *                       atomic exchange, so exactly one thread copies it
+ *                       out. The counters of every thread and deque are
+ *                       merged into stats at the end, along with the time
+ *                       it took every thread to stop after the limit.
+ *          Input: limit -> stop after this many solutions, 0 for no limit
+ *          Output: number of solutions found, at most limit. The first one
+ *                  found is left in board.
+ *          Calls: propagate(), is_complete(), min_choice_tile(),
+ *                 copy_matrix(), restore(), and Sudoku class methods.
+ */
+
+long Parallel::count(long limit)
+{
     // first see if we can solve without guess and check
-    propagate(groups);
-    if(is_complete())
-        return;
-
-    // set up stack and lock for parallel regions
-    vector<vector<Tile>> stack;
-    omp_lock_t stack_lock;
-    omp_init_lock(&stack_lock);
-
-    // determine the # of elements to initialize
-    // our stack with based off of the # of threads
-    int range;
-    #pragma omp parallel
     {
-        range = omp_get_num_threads() / 2;
+        ScopedTimer timer(PHASE_PROPAGATE);
+        if(!propagate(board))
+            return 0;
+        if(is_complete())
+            return 1;
     }
 
-	if(range > dim)
-		range = dim;
-	else if(range < 1)
-		range = 1;
-
-    // initialize stack with some paths to start with
-    // do this in serial since it is faster
-    for(int i = 0; i < range; i++)
+    int threads = omp_get_max_threads();
+    WorkStealer<Branch> work(threads);
+
+    // solutions found so far when there is a limit to check against
+    atomic<long> shared(0);
+    long total = 0;
+    atomic<int> have_first(0);
+    Board first;
+    uint64_t stopped_at = 0;
+
+    // pools outlive the parallel region since a stolen block is
+    // returned to the pool of the thread that stole it
+    vector<BoardPool*> pools;
+    for(int i = 0; i < threads; i++)
+        pools.push_back(new BoardPool(board.bytes));
+
+    // initialize the deques with the guesses for the tile with the
+    // least amount of candidates, dealt out round robin
+    int min_tile = min_choice_tile(board);
+    mask_t options = board.cand[min_tile];
+    STAT_ADD(stats, nodes, 1);
+    for(int i = 0; options; i++)
     {
-        Tile* min_tile = min_choice_tile_row(i);
-        for(unsigned int j = 0; j < min_tile->candidates.size(); j++)
-        {
-            vector<Tile> path;
-            vector<int> empty;
-            Tile tmp(min_tile->row, min_tile->col, min_tile->candidates[j]);
-            tmp.candidates = empty;
-            path.push_back(tmp);
-            stack.push_back(path);
-        }
+        Branch branch = {copy_matrix(board, *pools[i % threads]),
+                         min_tile, mask_lowest(options), 1};
+        options &= options - 1;
+        work.push(i % threads, std::move(branch));
     }
 
     // guess and check loop
-    #pragma omp parallel
+    #pragma omp parallel num_threads(threads) reduction(+:total)
     {
-        while (!stack.empty()) {
-            // place cancellation point at beginning for
-            // increased performance
-            #pragma omp cancellation point parallel
-
-            // make copy of groups for each thread to use
-            vector<vector<Tile *>> tmp_matrix = copy_matrix(matrix);
-
-            // get next path off stack
-            vector<Tile> path;
-            #pragma omp cancellation point parallel
-            if(!stack.empty()) {
-                omp_set_lock(&stack_lock);
-                path = stack.back();
-                stack.pop_back();
-                omp_unset_lock(&stack_lock);
-            }
-
-            // create puzzle using path
-            for (unsigned int i = 0; i < path.size(); i++) {
-                int row = path[i].row;
-                int col = path[i].col;
-                tmp_matrix[row][col]->val = path[i].val;
-                tmp_matrix[row][col]->candidates = path[i].candidates;
+        int tid = omp_get_thread_num();
+        BoardPool &pool = *pools[tid];
+
+        // each thread reuses one puzzle, loaded from the saved board,
+        // and drops the guess it is on once the search is cancelled
+        Sudoku thread_puzzle(board);
+        thread_puzzle.engine.stop = &work.stop;
+        Branch branch;
+
+        while (work.pop(tid, branch)) {
+            thread_puzzle.board.load(branch.state);
+            pool.put(branch.state);
+            STAT_ADD(thread_puzzle.stats, guesses, 1);
+            STAT_MAX(thread_puzzle.stats, max_depth, branch.depth);
+
+            // check state of puzzle after the guess
+            if (!thread_puzzle.propagate(branch.cell, branch.val)) {
+                // continue to next guess in the deque
+                STAT_ADD(thread_puzzle.stats, backtracks, 1);
+                work.done();
+                continue;
             }
 
-            Sudoku thread_puzzle(tmp_matrix, dim);
-            // solve as much as we can
-            #pragma omp cancellation point parallel
-            thread_puzzle.propagate();
+            // puzzle is solved, keep the first solution and
+            // stop everyone once the limit is reached
+            int min_tile = thread_puzzle.min_choice_tile();
+            if (min_tile == -1) {
+                if (!have_first.load() && !have_first.exchange(1))
+                    first = thread_puzzle.board;
+                total++;
+                if (limit && ++shared == limit) {
+                    stopped_at = ReadClock();
+                    work.cancel();
+                }
 
-            // check state of puzzle
-            int status;
-            if (!thread_puzzle.is_valid(status)) {
-                // continue to next puzzle in the stack
-                continue;
+            // not solved, but valid, store the guesses for the
+            // next tile, then move to next guess
             } else {
-                // puzzle is solved
-                if (thread_puzzle.is_complete()) {
-                    restore(thread_puzzle.groups);
-                    # pragma omp cancel parallel
-
-                // not solved, but valid, store new potential
-                // guess puzzles, then move to next puzzle in stack
-                } else {
-                    Tile *min_tile = thread_puzzle.min_choice_tile();
-                    for (unsigned int i = 0; i < min_tile->candidates.size(); i++) {
-                        vector<int> empty;
-                        Tile tmp(min_tile->row, min_tile->col, min_tile->candidates[i]);
-                        tmp.candidates = empty;
-                        path.push_back(tmp);
-
-                        omp_set_lock(&stack_lock);
-                        stack.push_back(path);
-                        omp_unset_lock(&stack_lock);
-
-                        path.pop_back();
-                    }
+                mask_t options = thread_puzzle.board.cand[min_tile];
+                STAT_ADD(thread_puzzle.stats, nodes, 1);
+                while (options) {
+                    Branch child = {copy_matrix(thread_puzzle.board, pool),
+                                    min_tile, mask_lowest(options),
+                                    branch.depth + 1};
+                    options &= options - 1;
+                    work.push(tid, std::move(child));
                 }
             }
-            #pragma omp cancellation point parallel
+            work.done();
+        }
+
+        #pragma omp critical(parallel_tactics)
+        {
+            engine.merge(thread_puzzle.engine);
+            stats.merge(thread_puzzle.stats);
         }
     }
-    omp_destroy_lock(&stack_lock);
-    cout << "done" << endl;
+
+    // every thread has left the loop by the join
+    quiesce_ns = stopped_at ? ReadClock() - stopped_at : 0;
+    stats.quiesce_ns = quiesce_ns;
+
+    // propagation counted by the threads' engines, the
+    // deques counted the scheduling
+    stats.merge(engine.stats);
+    work.collect(stats);
+
+    // blocks still queued after a cancel go with their pools
+    for(int i = 0; i < threads; i++)
+        delete pools[i];
+
+    if(total)
+        restore(first);
+    return limit && total > limit ? limit : total;
 }
 
 /*
@@ -198,29 +215,17 @@ void Parallel::print()
     cout << "Dimension: " << dim << endl;
     cout << "Puzzle: " << endl;
 
-    int out = (int)matrix.size();
-    for(int i = 0; i < out; i++)
+    for(int i = 0; i < dim; i++)
     {
         cout << "\t";
-        int in = (int)matrix[i].size();
-        for(int j = 0; j < in; j++)
+        for(int j = 0; j < dim; j++)
         {
-            if(matrix[i][j]->val == -1)
-                cout << ".";
+            // numbers once the letters run out
+            int v = board.val[i * dim + j];
+            if(dim > TOKEN_DIM)
+                cout << setw(token_width(dim)) << (v == -1 ? 0 : v);
             else
-            {
-                if(dim > 16)
-                {
-                    int num = matrix[i][j]->val + 96;
-                    printf("%c", (char)num);
-                }
-                else if(dim == 16)
-                {
-                    printf("%x", matrix[i][j]->val - 1);
-                }
-                else
-                    printf("%x", matrix[i][j]->val);
-            }
+                cout << encode_value(v, dim);
             cout << " ";
         }
         cout << endl;
@@ -241,9 +246,9 @@ int Parallel::is_valid(int &return_status)
 {
     int success = 1;
     return_status = 0;
-    for(unsigned int i = 0; i < groups.size(); i++)
+    for(int i = 0; i < layout->num_groups; i++)
     {
-        vector<Tile*> group = groups[i];
+        const int *group = layout->group(i);
         int stop = 0;
 
         // check to make sure each one is valid
@@ -251,13 +256,16 @@ int Parallel::is_valid(int &return_status)
         {
             for(int k = j + 1; k < dim; k++)
             {
-                if(group[j]->val == group[k]->val && group[j]->val != -1)
+                if(board.val[group[j]] == board.val[group[k]] &&
+                   board.val[group[j]] != -1)
                 {
                     success = 0;
                     stop = (i % 3) + 1;
                     return_status = (stop * 10000) +
-                                    (group[j]->row + 1) * 1000 + (group[j]->col * 100) +
-                                    (group[k]->row * 10) + group[k]->col;
+                                    (layout->row(group[j]) + 1) * 1000 +
+                                    (layout->col(group[j]) * 100) +
+                                    (layout->row(group[k]) * 10) +
+                                    layout->col(group[k]);
                     break;
                 }
             }
@@ -281,231 +289,68 @@ int Parallel::is_valid(int &return_status)
 
 int Parallel::is_complete()
 {
-    for(int i = 0; i < dim; i++)
+    for(int c = 0; c < board.cells; c++)
     {
-        for(int j = 0; j < dim; j++)
-        {
-            if(matrix[i][j]->val == -1)
-                return 0;
-        }
+        if(board.val[c] == -1)
+            return 0;
     }
     return 1;
 }
 
-/*
- * get_row()
- *              Description: Returns a certain row from a 2d grid of vectors
- *              Input: input -> 2d grid of vectors from which to get a row
- *                     row -> index of the row to get from input
- *              Output: a row from the matrix
- *              Calls: None
- */
-
-vector<Tile*> Parallel::get_row(vector<vector<Tile*>> input, int row)
-{
-    vector<Tile*> tmp;
-    for(int i = 0; i < dim; i++)
-    {
-        tmp.push_back(input[row][i]);
-    }
-    return tmp;
-
-}
-
-/*
- * get_col()
- *              Description: Returns a certain col from a 2d grid of vectors
- *              Input: input -> 2d grid of vectors from which to get a col
- *                     col -> index of the col to get from input
- *              Output: a col from the matrix
- *              Calls: None
- */
-
-vector<Tile*> Parallel::get_col(vector<vector<Tile*>> input, int col)
-{
-    vector<Tile*> tmp;
-    for(int i = 0; i < dim; i++)
-    {
-        tmp.push_back(input[i][col]);
-    }
-    return tmp;
-
-}
-
-/*
- * get_nonet()
- *              Description: Returns a certain nonet from a 2d grid of vectors.
- *                           The ordering of nonets is as follows:
- *                           0 1 2
- *                           3 4 5
- *                           6 7 8
- *              Input: input -> 2d grid of vectors from which to get a nonet
- *                     nonet -> index of the nonet to get from input
- *              Output: a nonet from the matrix
- *              Calls: None
- */
-
-vector<Tile*> Parallel::get_nonet(vector<vector<Tile*>> input, int non)
-{
-    vector<Tile*> tmp;
-
-    // calculate the row and col offset for the top right index into the puzzle
-    // for a specific nonet
-    int row = (non / nonet) * nonet;
-    int col = (non % nonet) * nonet;
-    int saved_col = col;
-    for(int i = 0; i < dim; i++)
-    {
-        tmp.push_back(input[row][col++]);
-
-        // every "nonet" # values,
-        // reset col index to start at the far left of the nonet
-        // and move to next row in the nonet
-        if((i + 1) % nonet == 0)
-        {
-            row++;
-            col = saved_col;
-        }
-    }
-    return tmp;
-}
-
 /*
  * copy_matrix()
- *                  Description: Creates an identical copy of a 2d matrix
- *                               of Tile pointers. Used in solve().
- *                  Input: 2d source matrix
- *                  Output: copy of the input matrix
- *                  Calls: None
+ *                  Description: Saves an identical copy of a board into a
+ *                               block from a pool. Used in solve(). The
+ *                               board lives in a single buffer so this is
+ *                               one memcpy.
+ *                  Input: input -> board to copy
+ *                         pool -> the calling thread's pool
+ *                  Output: block holding the copy
+ *                  Calls: BoardPool.get(), Board.save()
  */
 
-vector<vector<Tile*>> Parallel::copy_matrix(vector<vector<Tile*>> input)
+char* Parallel::copy_matrix(const Board &input, BoardPool &pool)
 {
-    vector<vector<Tile*>> output;
-    for(unsigned int i = 0; i < input.size(); i++)
-    {
-        vector<Tile*> tmp;
-        for(unsigned int j = 0; j < input[i].size(); j++)
-        {
-            // allocate memory for pointer to Tile object
-            Tile *new_tile = new Tile();
-            new_tile->row = input[i][j]->row;
-            new_tile->col = input[i][j]->col;
-            new_tile->val = input[i][j]->val;
-            new_tile->candidates = input[i][j]->candidates;
-            tmp.push_back(new_tile);
-        }
-        output.push_back(tmp);
-    }
-    return output;
-}
-
-/*
- * group_create()
- *                  Description: For a given matrix, generates an array of row,
- *                               column, and nonet arrays from the matrix 
- *                               representation. This way, when checking for
- *                               candidate values for a square, we do not have
- *                               to manually check the row, column and nonet 
- *                               for each square. Instead, each of these are
- *                               stored in the group format.
- *                  Input: 2d matrix of Tiles
- *                  Output: row, col, and nonet groups of Tiles of the matrix
- *                  Calls: get_row(), get_col(), get_nonet()
- */
-
-vector<vector<Tile*>> Parallel::group_create(vector<vector<Tile*>> cpy_matrix)
-{
-    vector<vector<Tile*>> output;
-    for(unsigned int i = 0; i < cpy_matrix.size(); i++)
-    {
-        vector<Tile*> tmp = get_row(cpy_matrix, i);
-        output.push_back(tmp);
-
-        tmp = get_col(cpy_matrix, i);
-        output.push_back(tmp);
-
-        tmp = get_nonet(cpy_matrix, i);
-        output.push_back(tmp);
-    }
-    return output;
+    char *state = pool.get();
+    input.save(state);
+    return state;
 }
 
 /*
  * restore()
- *              Description: Given a solved puzzle (in group form), store the
- *                           puzzles state in the objects matrix variable.
- *              Input: group format of a solved puzzle
+ *              Description: Given a solved puzzle, store the puzzles state
+ *                           in the objects board variable.
+ *              Input: a solved board
  *              Output: None
  *              Calls: None
  */
 
-void Parallel::restore(const vector<vector<Tile*>>& solved)
+void Parallel::restore(const Board &solved)
 {
-    for(unsigned int i = 0, j = 0; i < solved.size(); i += 3, j++)
-    {
-        matrix[j] = solved[i];
-    }
+    board = solved;
 }
 
 /*
  * min_choice_tile()
- *                  Description: For a given puzzle in group format, this
- *                               function finds the Tile with the least amount
- *                               of candidates.
- *                  Input: a puzzle in group format
- *                  Output: a Tile pointer
+ *                  Description: For a given board, this function finds the
+ *                               cell with the least amount of candidates.
+ *                  Input: a board
+ *                  Output: a cell index, -1 if no empty cell was found
  *                  Calls: None
  */
 
-Tile* Parallel::min_choice_tile(vector<vector<Tile*>> puzzle)
+int Parallel::min_choice_tile(const Board &puzzle)
 {
-    /* puzzle will be group format */
-    Tile *choice = NULL;
-    unsigned int min_tile_num = dim;
-    // only iterate through the row group in the puzzle
-    for(unsigned int i = 0; i < puzzle.size(); i += 3)
+    int choice = -1;
+    int min_tile_num = dim + 1;
+    for(int c = 0; c < puzzle.cells; c++)
     {
-        for(unsigned int j = 0; j < puzzle[i].size(); j++)
+        if(puzzle.val[c] == -1)
         {
-            if(puzzle[i][j]->val == -1)
+            if(mask_count(puzzle.cand[c]) < min_tile_num)
             {
-                if(puzzle[i][j]->candidates.size() < min_tile_num)
-                {
-                    choice = puzzle[i][j];
-                    min_tile_num = puzzle[i][j]->candidates.size();
-                }
-            }
-        }
-    }
-    return choice;
-}
-
-/*
- * min_choice_tile_row()
- *                      Description: See min_choice_tile(). Operates the same
- *                                   except it finds the tile with the least 
- *                                   amount of candidates in specific row, and
- *                                   it operates over the objects matrix form 
- *                                   of the puzzle. Used only for initiating 
- *                                   the stack in solve().
- *                      Input: A given row to search
- *                      Output: A Tile pointer to the minimum tile in that row
- *                      Calls: None
- */
-
-Tile* Parallel::min_choice_tile_row(int row)
-{
-    Tile *choice = NULL;
-    unsigned int min_tile_num = dim;
-    for(unsigned int j = 0; j < matrix[row].size(); j++)
-    {
-        if(matrix[row][j]->val == -1)
-        {
-            if(matrix[row][j]->candidates.size() < min_tile_num)
-            {
-                choice = matrix[row][j];
-                min_tile_num = matrix[row][j]->candidates.size();
+                choice = c;
+                min_tile_num = mask_count(puzzle.cand[c]);
             }
         }
     }
@@ -515,150 +360,15 @@ Tile* Parallel::min_choice_tile_row(int row)
 /*
  * propagate()
  *              Description: Driver function for tactics to propagate values
- *                           into each tile in the puzzle. Input puzzle is in
- *                           group format.
- *              Input: 2d grid of Tile's to apply tacitcs to
- *              Ouput: None
- *              Calls: elimination() lone_ranger()
+ *                           into each tile in the puzzle.
+ *              Input: board to apply tacitcs to
+ *              Ouput: returns 0 if the puzzle is no longer valid, 1 otherwise
+ *              Calls: Propagator.propagate()
  */
 
-void Parallel::propagate(vector<vector<Tile*>> &input)
+int Parallel::propagate(Board &input)
 {
-    // keep applying tactics until we no longer
-    // are making changes to the candidates of the puzzle
-    int cont = 1;
-    while(cont)
-    {
-        cont = elimination(input);
-        lone_ranger(input);
-    }
-}
-
-/*
- * elimination()
- *              Description: For a given puzzle in group form, this function
- *                           checks for each group (row, column, or nonet)
- *                           the possible candidates for that group, and then
- *                           for each tile in the group, then eliminates 
- *                           candidates for that particular tile depending upon
- *                           which values are available in that group. If there
- *                           is only one available candidate left for a Tile,
- *                           then the Tile's value is set to that candidate.
- *              Input: 2d grid of Tile's
- *              Output: returns 1 if a change was made, and 0 if a change was
- *                      not made to any Tile's candidates in the puzzle
- *              Calls: Tile.remove_candidates()
- */
-
-int Parallel::elimination(vector<vector<Tile*>> &input)
-{
-    // loop through each group of the puzzle
-    int return_value = 0;
-    for(unsigned int i = 0; i < input.size(); i++)
-    {
-        // determine which values are already used
-        // in the group (i.e. cannot be candidates)
-        set<int> used_values;
-        for(unsigned int j = 0; j < input[i].size(); j++)
-        {
-            if(in(input[i][j]->val, choices))
-                used_values.insert(input[i][j]->val);
-        }
-
-        // for each tile, eliminate candidates for that tile
-        for(unsigned int j = 0; j < input[i].size(); j++)
-        {
-            vector<int> tmp{used_values.begin(), used_values.end()};
-            int change_made = input[i][j]->remove_candidates(tmp);
-
-            // set return value if a change was made to the
-            // candidates of the tile
-            if(change_made)
-                return_value = 1;
-        }
-    }
-    return return_value;
-
-}
-
-/*
- * lone_ranger()
- *              Description: For a given puzzle in group for, this function
- *                           checks for each group (row, column, or nonet)
- *                           if there is an empty Tile such that one of the
- *                           candidates for that empty Tile does not appear
- *                           as one of the candidates for any other Tile in the
- *                           same group. If this is true, then it sets that 
- *                           particular candidate as the value for the Tile.
- *              Input: 2d puzzle of Tile's
- *              Output: returns 1 if a change was made to the state of the 
- *                      puzzle, 0 otherwise.
- *              Calls: None
- */
-
-int Parallel::lone_ranger(vector<vector<Tile*>> &input)
-{
-    // loop through groups of the puzzle
-    int return_value = 0;
-    for (unsigned int i = 0; i < input.size(); i++) {
-
-        // find which values have not been used for the group
-        set<int> leftovers{choices.begin(), choices.end()};
-        for (unsigned int j = 0; j < input[i].size(); j++) {
-            if (in(input[i][j]->val, choices))
-                leftovers.erase(groups[i][j]->val);
-        }
-
-        // for each available value of the group
-        vector<int> replace{leftovers.begin(), leftovers.end()};
-        for (unsigned int j = 0; j < replace.size(); j++) {
-
-            // iterate through each tile in the group, counting
-            // how many empty tiles have available
-            // value as a candidate
-            int num_leftover = 0;
-            int place_holder;
-            for (unsigned int k = 0; k < input[i].size(); k++) {
-                if (in(replace[j], input[i][k]->candidates)) {
-                    num_leftover++;
-                    place_holder = k;
-                }
-            }
-
-            // only one empty tile has available value as a candidate
-            // must be the value for the Tile
-            if (num_leftover == 1) {
-                input[i][place_holder]->val = replace[j];
-                input[i][place_holder]->candidates.clear();
-                return_value = 1;
-            }
-        }
-    }
-    return return_value;
-}
-
-/*
- *  in()
- *          Description: Simple helper function for elimination() and
- *                       lone_ranger(). Checks if a given value is in a vector
- *          Input: val -> particular value to check if it is in the list
- *                 list -> list to be scanned for value
- *          Output: returns 1 if the value is in the list, 0 otherwise.
- *          Calls: None
- */
-
-int Parallel::in(int val, vector<int> list)
-{
-
-    // loop through vector checking for value
-    int return_value = 0;
-    for(unsigned int i = 0; i < list.size(); i++)
-    {
-        if(list[i] == val)
-        {
-            return_value = 1;
-            break;
-        }
-    }
-    return return_value;
+    // keep applying tactics until the worklist
+    // of changed groups is empty
+    return engine.propagate(input);
 }
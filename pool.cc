@@ -0,0 +1,161 @@
+/*
+ * Author: Luke Vandecasteele
+ *
+ * Credits: Matthew Trappert, Dr. Jee W. Choi, Class notes, and other sources
+ *          listed in final report.
+ *
+ * Date Created: 10/16/2026
+ * Last Modified: 10/16/2026
+ *
+ * Description: Final project for CIS 431 at the University of Oregon Fall
+ *              2021. Implementation of the BoardPool class, a slab of fixed
+ *              size blocks that hold saved board states for the parallel
+ *              search.
+ * Notes:
+ *       1. See header.h for all class methods and variables.
+ *       2. All methods contain headers for individual usage and description.
+ *       3. Chunks are mapped with mmap and the free list is threaded through
+ *          the blocks themselves, so get() and put() never call the global
+ *          allocator. Memory only grows when more blocks are in use at once
+ *          than ever before.
+ *
+ */
+
+#include <sys/mman.h>
+#include "header.h"
+
+#define CACHE_LINE 64
+#define HUGE_PAGE (1 << 21)
+
+int BoardPool::huge_pages = 0;
+
+// chunk header, kept in the first cache line of every chunk
+struct Chunk
+{
+    Chunk *next;
+    size_t bytes;
+};
+
+// Constructor
+BoardPool::BoardPool(size_t bytes)
+{
+    block = (bytes + CACHE_LINE - 1) & ~(size_t)(CACHE_LINE - 1);
+    chunks = NULL;
+    free_list = NULL;
+    next = NULL;
+    end = NULL;
+    mapped = 0;
+}
+
+// Destructor
+BoardPool::~BoardPool()
+{
+    reset();
+}
+
+/*
+ * get()
+ *          Description: Hands out a block, the most recently returned one if
+ *                       there is any since it is likely still in cache.
+ *          Input: None
+ *          Output: a block of at least the size given to the constructor,
+ *                  aligned to a cache line
+ *          Calls: grow()
+ */
+
+char* BoardPool::get()
+{
+    if(free_list)
+    {
+        char *p = free_list;
+        free_list = *(char **)p;
+        return p;
+    }
+    if(next == end)
+        grow();
+    char *p = next;
+    next += block;
+    return p;
+}
+
+/*
+ * put()
+ *          Description: Returns a block. Blocks may be returned to a
+ *                       different pool than the one they came from as long
+ *                       as the pools are the same size and live equally
+ *                       long, which is how stolen work is recycled.
+ *          Input: p -> block from get()
+ *          Output: None
+ *          Calls: None
+ */
+
+void BoardPool::put(char *p)
+{
+    *(char **)p = free_list;
+    free_list = p;
+}
+
+/*
+ * reset()
+ *          Description: Unmaps every chunk. All blocks handed out become
+ *                       invalid at once, whether or not they were returned.
+ *          Input: None
+ *          Output: None
+ *          Calls: None
+ */
+
+void BoardPool::reset()
+{
+    Chunk *c = (Chunk *)chunks;
+    while(c)
+    {
+        Chunk *n = c->next;
+        munmap(c, c->bytes);
+        c = n;
+    }
+    chunks = NULL;
+    free_list = NULL;
+    next = end = NULL;
+    mapped = 0;
+}
+
+/*
+ * grow()
+ *          Description: Maps a new chunk of at least 2MB for the blocks to be
+ *                       carved from. With huge_pages set, explicit huge pages
+ *                       are tried first, then transparent huge pages are
+ *                       asked for on a normal mapping.
+ *          Input: None
+ *          Output: None
+ *          Calls: None
+ */
+
+void BoardPool::grow()
+{
+    size_t bytes = CACHE_LINE + block * 32;
+    bytes = (bytes + HUGE_PAGE - 1) & ~(size_t)(HUGE_PAGE - 1);
+
+    void *p = MAP_FAILED;
+    if(huge_pages)
+        p = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if(p == MAP_FAILED)
+    {
+        p = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(p == MAP_FAILED)
+            throw bad_alloc();
+        if(huge_pages)
+            madvise(p, bytes, MADV_HUGEPAGE);
+    }
+
+    Chunk *c = (Chunk *)p;
+    c->next = (Chunk *)chunks;
+    c->bytes = bytes;
+    chunks = (char *)c;
+    mapped += bytes;
+
+    // blocks start after the header, only whole blocks are used
+    next = (char *)p + CACHE_LINE;
+    end = next + (bytes - CACHE_LINE) / block * block;
+}
@@ -0,0 +1,971 @@
+/*
+ * Author: Luke Vandecasteele
+ *
+ * Credits: Matthew Trappert, Dr. Jee W. Choi, Class notes, and other sources
+ *          listed in final report.
+ *
+ * Date Created: 10/16/2026
+ * Last Modified: 10/17/2026
+ *
+ * Description: Final project for CIS 431 at the University of Oregon Fall
+ *              2021. Implementation of the Propagator class, the event
+ *              driven engine behind the elimination() and lone_ranger()
+ *              tactics used by both the serial and parallel solvers.
+ * Notes:
+ *       1. See header.h for all class methods and variables.
+ *       2. All methods contain headers for individual usage and description.
+ *       3. Only groups touched by an assignment or a domain reduction are
+ *          put on the worklist, so a guess deep in the search usually only
+ *          revisits a handful of groups instead of all 3 * dim of them.
+ *
+ */
+
+#include "header.h"
+
+int Propagator::default_tactics = 0;
+// below this a sweep costs more to start than it saves
+int Propagator::sweep_dim = 49;
+
+const char *Propagator::tactic_names[NUM_TACTICS] = {
+    "naked_single",
+    "hidden_single",
+    "naked_pair",
+    "naked_triple",
+    "naked_quad",
+    "hidden_pair",
+    "hidden_triple",
+    "hidden_quad",
+    "pointing",
+    "box_line",
+    "x_wing",
+    "swordfish"
+};
+
+// Constructor
+Propagator::Propagator()
+{
+    layout = NULL;
+    head = 0;
+    count = 0;
+    tactics = default_tactics;
+    changes = 0;
+    stop = NULL;
+    for(int t = 0; t < NUM_TACTICS; t++)
+        counts[t] = 0;
+}
+
+/*
+ * reset()
+ *          Description: Sizes the worklist for the board's dimension and
+ *                       empties it. Called whenever propagation gives up
+ *                       part way through so stale groups are not kept.
+ *          Input: board -> board about to be propagated
+ *          Output: None
+ *          Calls: None
+ */
+
+void Propagator::reset(const Board &board)
+{
+    if(layout != board.layout)
+    {
+        layout = board.layout;
+        queue.assign(layout->num_groups, 0);
+        queued.assign(layout->num_groups, 0);
+    }
+    else
+    {
+        while(count)
+        {
+            queued[queue[head]] = 0;
+            head = (head + 1) % layout->num_groups;
+            count--;
+        }
+    }
+    head = 0;
+    count = 0;
+}
+
+/*
+ * push()
+ *          Description: Adds a group to the worklist if it is not already
+ *                       waiting on it.
+ *          Input: g -> group index
+ *          Output: None
+ *          Calls: None
+ */
+
+void Propagator::push(int g)
+{
+    if(queued[g])
+        return;
+    queued[g] = 1;
+    queue[(head + count) % layout->num_groups] = g;
+    count++;
+}
+
+/*
+ * assign()
+ *          Description: Places a value into a cell and schedules the cell's
+ *                       row, col, and nonet for propagation.
+ *          Input: board -> board to modify
+ *                 c -> cell index
+ *                 v -> value to place
+ *          Output: returns 0 if the value is already used by one of the
+ *                  cell's groups (the puzzle is no longer valid), 1 otherwise
+ *          Calls: Board.assign(), push()
+ */
+
+int Propagator::assign(Board &board, int c, int v)
+{
+    if(board.val[c] != -1)
+        return board.val[c] == v;
+
+    const int *g = board.layout->groups_of(c);
+    mask_t bit = mask_bit(v);
+    if((board.used[g[0]] | board.used[g[1]] | board.used[g[2]]) & bit)
+        return 0;
+
+    board.assign(c, v);
+    push(g[0]);
+    push(g[1]);
+    push(g[2]);
+    return 1;
+}
+
+/*
+ * propagate()
+ *              Description: Propagates a whole board, e.g. right after it
+ *                           was read. Every group starts on the worklist.
+ *              Input: board -> board to apply tactics to
+ *              Output: returns 1 if the board is still valid, 0 if a
+ *                      contradiction was found
+ *              Calls: reset(), push(), run()
+ */
+
+int Propagator::propagate(Board &board)
+{
+    reset(board);
+    STAT_ADD(stats, propagations, 1);
+
+    // given values that clash can not be caught by assign()
+    for(int g = 0; g < layout->num_groups; g++)
+    {
+        const int *group = layout->group(g);
+        int filled = 0;
+        for(int k = 0; k < layout->dim; k++)
+            filled += board.val[group[k]] != -1;
+        if(filled != mask_count(board.used[g]))
+            return 0;
+        push(g);
+    }
+    return run(board);
+}
+
+/*
+ * propagate()
+ *              Description: Places one value (a guess) and propagates only
+ *                           its consequences.
+ *              Input: board -> already propagated board
+ *                     c -> cell index
+ *                     v -> value to place
+ *              Output: returns 1 if the board is still valid, 0 if a
+ *                      contradiction was found
+ *              Calls: reset(), assign(), run()
+ */
+
+int Propagator::propagate(Board &board, int c, int v)
+{
+    reset(board);
+    STAT_ADD(stats, propagations, 1);
+    if(!assign(board, c, v))
+        return 0;
+    return run(board);
+}
+
+/*
+ * reduce()
+ *          Description: Removes values from the candidates of an empty cell,
+ *                       placing the last one if only one is left. Used by
+ *                       the optional tactics.
+ *          Input: board -> board to modify
+ *                 c -> cell index
+ *                 remove -> values to remove
+ *          Output: returns 0 if the cell was left without candidates, 1
+ *                  otherwise
+ *          Calls: assign(), push()
+ */
+
+int Propagator::reduce(Board &board, int c, mask_t remove)
+{
+    if(board.val[c] != -1)
+        return 1;
+
+    mask_t cand = board.cand[c] & ~remove;
+    if(cand == board.cand[c])
+        return 1;
+    if(cand == 0)
+        return 0;
+
+    changes++;
+    if((cand & (cand - 1)) == 0)
+        return assign(board, c, mask_lowest(cand));
+
+    board.set_cand(c, cand);
+    const int *cg = layout->groups_of(c);
+    push(cg[0]);
+    push(cg[1]);
+    push(cg[2]);
+    return 1;
+}
+
+/*
+ * run()
+ *          Description: Applies elimination() and then lone_ranger() to the
+ *                       next group on the worklist until the worklist is
+ *                       empty. Then tries the optional tactics, and starts
+ *                       over if they reduced anything. Checks stop before
+ *                       every group, so a cancelled search does not finish
+ *                       a long propagation on a large board. A long
+ *                       worklist on a large board is handed to sweep().
+ *          Input: board -> board to apply tactics to
+ *          Output: returns 1 if the board is still valid, 0 if a
+ *                  contradiction was found or the search was stopped
+ *          Calls: elimination(), lone_ranger(), advanced(), sweep(),
+ *                 reset()
+ */
+
+int Propagator::run(Board &board)
+{
+    for(;;)
+    {
+        while(count)
+        {
+            // a stopped search treats the board as a dead end
+            if(stop && stop->load(memory_order_relaxed))
+            {
+                reset(board);
+                return 0;
+            }
+
+            // a long worklist on a large board is split across threads
+            if(count >= layout->dim && layout->dim >= sweep_dim &&
+               !omp_in_parallel() && omp_get_max_threads() > 1)
+            {
+                if(!sweep(board))
+                {
+                    reset(board);
+                    return 0;
+                }
+                continue;
+            }
+
+            int g = queue[head];
+            head = (head + 1) % layout->num_groups;
+            count--;
+            queued[g] = 0;
+            STAT_ADD(stats, groups, 1);
+
+            if(!elimination(board, g) || !lone_ranger(board, g))
+            {
+                reset(board);
+                return 0;
+            }
+        }
+
+        // singles are exhausted, anything the optional
+        // tactics remove is put back on the worklist
+        if(!tactics)
+            return 1;
+        if(!advanced(board))
+        {
+            reset(board);
+            return 0;
+        }
+        if(!count)
+            return 1;
+    }
+}
+
+/*
+ * sweep()
+ *          Description: Applies elimination and lone_ranger to every group
+ *                       on the worklist at once, on all threads. The groups
+ *                       are taken rows first, then cols, then nonets, with
+ *                       a barrier in between. The groups of one kind share
+ *                       no cells, so each thread only narrows the domains
+ *                       of the cells in its own groups and no update needs
+ *                       a lock. Domains are narrowed in a copy of the
+ *                       candidates, and used[] is only read, so the board
+ *                       and its trail are left to one thread: the values
+ *                       are placed and the narrowed candidates written back
+ *                       afterwards, putting the groups they touch back on
+ *                       the worklist.
+ *          Input: board -> board to apply tactics to
+ *          Output: returns 1 if the board is still valid, 0 if a
+ *                  contradiction was found
+ *          Calls: group_counts(), assign(), push()
+ */
+
+int Propagator::sweep(Board &board)
+{
+    int dim = layout->dim;
+
+    // take the worklist, ordered by kind of group
+    int first[4];
+    batch.clear();
+    for(int kind = 0; kind < 3; kind++)
+    {
+        first[kind] = batch.size();
+        for(int i = 0; i < dim; i++)
+        {
+            if(queued[3 * i + kind])
+                batch.push_back(3 * i + kind);
+        }
+    }
+    first[3] = batch.size();
+    reset(board);
+    STAT_ADD(stats, groups, batch.size());
+
+    domain.assign(board.cand, board.cand + board.cells);
+    mask_t *dom = &domain[0];
+    const mask_t *used = board.used;
+    const int8_t *val = board.val;
+    int bad = 0;
+
+    // which cells lone_ranger narrowed, so a cell found in more than
+    // one phase is still counted once, when it is written back
+    lone_cell.assign(board.cells, 0);
+    char *by_lone = &lone_cell[0];
+
+    #pragma omp parallel reduction(|:bad)
+    for(int kind = 0; kind < 3; kind++)
+    {
+        #pragma omp for schedule(static)
+        for(int i = first[kind]; i < first[kind + 1]; i++)
+        {
+            int g = batch[i];
+            const int *group = layout->group(g);
+            if(bad)
+                continue;
+
+            // elimination
+            for(int k = 0; k < dim; k++)
+            {
+                int c = group[k];
+                if(val[c] == -1 && (dom[c] &= ~used[g]) == 0)
+                    bad = 1;
+            }
+
+            // lone_ranger
+            mask_t once;
+            mask_t twice;
+            group_counts(dom, group, dim, once, twice);
+            mask_t missing = mask_all(dim) & ~used[g];
+            if(missing & ~once)
+                bad = 1;
+
+            mask_t lone = missing & once & ~twice;
+            while(lone && !bad)
+            {
+                mask_t value = lone & -lone;
+                lone &= lone - 1;
+
+                int k = 0;
+                while(k < dim && !(dom[group[k]] & value))
+                    k++;
+
+                // the cell already took another lone value
+                if(k == dim)
+                    bad = 1;
+                else
+                {
+                    int c = group[k];
+                    by_lone[c] |= dom[c] != value;
+                    dom[c] = value;
+                }
+            }
+        }
+    }
+    if(bad)
+        return 0;
+
+    // place the singles and write back the rest on this thread
+    for(int c = 0; c < board.cells; c++)
+    {
+        mask_t d = dom[c];
+        if(val[c] != -1 || d == board.cand[c])
+            continue;
+
+        if((d & (d - 1)) == 0)
+        {
+            if(!assign(board, c, mask_lowest(d)))
+                return 0;
+            counts[by_lone[c] ? HIDDEN_SINGLE : NAKED_SINGLE]++;
+        }
+        else
+        {
+            board.set_cand(c, d);
+            const int *cg = layout->groups_of(c);
+            push(cg[0]);
+            push(cg[1]);
+            push(cg[2]);
+        }
+    }
+    return 1;
+}
+
+/*
+ * elimination()
+ *              Description: Removes the values used in a group from the
+ *                           candidates of the group's empty cells. A cell
+ *                           left with one candidate is set to it. Any cell
+ *                           whose candidates shrink has its other groups
+ *                           scheduled, since lone_ranger() may now apply
+ *                           there.
+ *              Input: board -> board to apply tactic to
+ *                     g -> group index
+ *              Output: returns 0 if a cell was left without candidates, 1
+ *                      otherwise
+ *              Calls: group_changed(), assign(), push()
+ */
+
+int Propagator::elimination(Board &board, int g)
+{
+    const int *group = layout->group(g);
+
+    // only visit the cells that still hold a used value
+    mask_t changed = group_changed(board.cand, group, layout->dim,
+                                   board.used[g]);
+    while(changed)
+    {
+        int c = group[mask_lowest(changed) - 1];
+        changed &= changed - 1;
+        if(board.val[c] != -1)
+            continue;
+
+        // used[g] may have grown since the scan
+        mask_t cand = board.cand[c] & ~board.used[g];
+        if(cand == 0)
+            return 0;
+
+        if((cand & (cand - 1)) == 0)
+        {
+            if(!assign(board, c, mask_lowest(cand)))
+                return 0;
+            counts[NAKED_SINGLE]++;
+        }
+        else
+        {
+            board.set_cand(c, cand);
+            const int *cg = layout->groups_of(c);
+            push(cg[0]);
+            push(cg[1]);
+            push(cg[2]);
+        }
+    }
+    return 1;
+}
+
+/*
+ * lone_ranger()
+ *              Description: Checks whether a value missing from a group is a
+ *                           candidate of exactly one of its empty cells, and
+ *                           if so places it there.
+ *              Input: board -> board to apply tactic to
+ *                     g -> group index
+ *              Output: returns 0 if a missing value can not be placed in any
+ *                      cell of the group, 1 otherwise
+ *              Calls: group_counts(), assign()
+ */
+
+int Propagator::lone_ranger(Board &board, int g)
+{
+    const int *group = layout->group(g);
+
+    // accumulate which values appear as a candidate at least
+    // once, and at least twice, across the cells of the group
+    mask_t once;
+    mask_t twice;
+    group_counts(board.cand, group, layout->dim, once, twice);
+
+    mask_t missing = mask_all(layout->dim) & ~board.used[g];
+    if(missing & ~once)
+        return 0;
+
+    mask_t lone = missing & ~twice;
+    while(lone)
+    {
+        mask_t value = lone & -lone;
+        lone &= lone - 1;
+
+        int k = 0;
+        while(k < layout->dim && !(board.cand[group[k]] & value))
+            k++;
+
+        // the cell already took another lone value
+        if(k == layout->dim)
+            return 0;
+        if(!assign(board, group[k], mask_lowest(value)))
+            return 0;
+        counts[HIDDEN_SINGLE]++;
+    }
+    return 1;
+}
+
+/*
+ * find_subset()
+ *          Description: Searches for n of the given masks whose union has
+ *                       exactly n bits, skipping masks that are empty or
+ *                       already too large. Used for naked and hidden subsets
+ *                       and for fish, which are the same search over
+ *                       different masks.
+ *          Input: masks -> masks to choose from
+ *                 count -> number of masks
+ *                 n -> size of the subset
+ *                 start -> first mask that may still be picked
+ *                 depth -> number of masks picked so far
+ *                 acc -> union of the picked masks
+ *                 picked -> bit i is set if mask i was picked
+ *                 found -> called with picked and acc for each subset,
+ *                          returns 1 to stop the search
+ *          Output: returns 1 if found stopped the search, 0 otherwise
+ *          Calls: found
+ */
+
+template <class F>
+static int find_subset(const mask_t *masks, int count, int n, int start,
+                       int depth, mask_t acc, mask_t picked, F &found)
+{
+    if(depth == n)
+        return mask_count(acc) == n && found(picked, acc);
+
+    for(int i = start; i < count; i++)
+    {
+        mask_t next = acc | masks[i];
+        if(masks[i] == 0 || mask_count(next) > n)
+            continue;
+        if(find_subset(masks, count, n, i + 1, depth + 1, next,
+                       picked | ((mask_t)1 << i), found))
+            return 1;
+    }
+    return 0;
+}
+
+/*
+ * advanced()
+ *              Description: Tries the optional tactics that are turned on
+ *                           over the whole board, cheapest first, and stops
+ *                           at the first one that reduces anything so the
+ *                           singles can follow up on it.
+ *              Input: board -> board to apply tactics to
+ *              Output: returns 0 if a contradiction was found, 1 otherwise
+ *              Calls: intersection(), naked_subset(), hidden_subset(),
+ *                     fish()
+ */
+
+int Propagator::advanced(Board &board)
+{
+    int groups = layout->num_groups;
+
+    if(tactics & ((1 << POINTING) | (1 << BOX_LINE)))
+    {
+        for(int g = 0; g < groups; g++)
+        {
+            if(!intersection(board, g))
+                return 0;
+        }
+        if(count)
+            return 1;
+    }
+
+    for(int n = 2; n <= 4; n++)
+    {
+        if(tactics & (1 << (NAKED_PAIR + n - 2)))
+        {
+            for(int g = 0; g < groups; g++)
+            {
+                if(!naked_subset(board, g, n))
+                    return 0;
+            }
+            if(count)
+                return 1;
+        }
+        if(tactics & (1 << (HIDDEN_PAIR + n - 2)))
+        {
+            for(int g = 0; g < groups; g++)
+            {
+                if(!hidden_subset(board, g, n))
+                    return 0;
+            }
+            if(count)
+                return 1;
+        }
+    }
+
+    for(int n = 2; n <= 3; n++)
+    {
+        if(!(tactics & (1 << (n == 2 ? X_WING : SWORDFISH))))
+            continue;
+        for(int v = 1; v <= layout->dim; v++)
+        {
+            if(!fish(board, v, n))
+                return 0;
+        }
+        if(count)
+            return 1;
+    }
+    return 1;
+}
+
+/*
+ * naked_subset()
+ *              Description: Looks for n empty cells of a group whose
+ *                           candidates together hold only n values (a naked
+ *                           pair, triple, or quad). Those values can not go
+ *                           anywhere else in the group.
+ *              Input: board -> board to apply tactic to
+ *                     g -> group index
+ *                     n -> size of the subset, 2 to 4
+ *              Output: returns 0 if a contradiction was found, 1 otherwise
+ *              Calls: find_subset(), reduce()
+ */
+
+int Propagator::naked_subset(Board &board, int g, int n)
+{
+    const int *group = layout->group(g);
+    int cells[MAX_DIM];
+    mask_t masks[MAX_DIM];
+    int m = 0;
+    for(int k = 0; k < layout->dim; k++)
+    {
+        if(board.val[group[k]] != -1)
+            continue;
+        cells[m] = group[k];
+        masks[m] = board.cand[group[k]];
+        m++;
+    }
+    if(m <= n)
+        return 1;
+
+    int t = NAKED_PAIR + n - 2;
+    int ok = 1;
+    auto found = [&](mask_t picked, mask_t values) -> int
+    {
+        long before = changes;
+        for(int i = 0; i < m; i++)
+        {
+            if((picked >> i) & 1)
+                continue;
+            if(!reduce(board, cells[i], values))
+            {
+                ok = 0;
+                return 1;
+            }
+        }
+        if(changes == before)
+            return 0;
+        counts[t]++;
+        return 1;
+    };
+    find_subset(masks, m, n, 0, 0, 0, 0, found);
+    return ok;
+}
+
+/*
+ * hidden_subset()
+ *              Description: Looks for n values missing from a group that are
+ *                           only candidates of the same n cells (a hidden
+ *                           pair, triple, or quad). Those cells can not hold
+ *                           any other value.
+ *              Input: board -> board to apply tactic to
+ *                     g -> group index
+ *                     n -> size of the subset, 2 to 4
+ *              Output: returns 0 if a contradiction was found, 1 otherwise
+ *              Calls: find_subset(), reduce()
+ */
+
+int Propagator::hidden_subset(Board &board, int g, int n)
+{
+    const int *group = layout->group(g);
+    int values[MAX_DIM];
+    mask_t where[MAX_DIM];
+    int m = 0;
+
+    // where each missing value can still go, bit k for cell k of the group
+    mask_t missing = mask_all(layout->dim) & ~board.used[g];
+    while(missing)
+    {
+        mask_t bit = missing & -missing;
+        missing &= missing - 1;
+        mask_t pos = 0;
+        for(int k = 0; k < layout->dim; k++)
+        {
+            if(board.cand[group[k]] & bit)
+                pos |= (mask_t)1 << k;
+        }
+        values[m] = mask_lowest(bit);
+        where[m] = pos;
+        m++;
+    }
+    if(m <= n)
+        return 1;
+
+    int t = HIDDEN_PAIR + n - 2;
+    int ok = 1;
+    auto found = [&](mask_t picked, mask_t cells) -> int
+    {
+        mask_t keep = 0;
+        for(int i = 0; i < m; i++)
+        {
+            if((picked >> i) & 1)
+                keep |= mask_bit(values[i]);
+        }
+
+        long before = changes;
+        while(cells)
+        {
+            int k = mask_lowest(cells) - 1;
+            cells &= cells - 1;
+            if(!reduce(board, group[k], ~keep))
+            {
+                ok = 0;
+                return 1;
+            }
+        }
+        if(changes == before)
+            return 0;
+        counts[t]++;
+        return 1;
+    };
+    find_subset(where, m, n, 0, 0, 0, 0, found);
+    return ok;
+}
+
+/*
+ * intersection()
+ *              Description: Pointing pairs and box line reduction. If every
+ *                           place left for a value in a nonet is on one row
+ *                           or col, the value can be removed from the rest of
+ *                           that row or col (pointing). If every place left
+ *                           in a row or col is in one nonet, it can be
+ *                           removed from the rest of that nonet (box line).
+ *              Input: board -> board to apply tactic to
+ *                     g -> group index
+ *              Output: returns 0 if a contradiction was found, 1 otherwise
+ *              Calls: reduce()
+ */
+
+int Propagator::intersection(Board &board, int g)
+{
+    int type = g % 3;
+    int t = type == 2 ? POINTING : BOX_LINE;
+    if(!(tactics & (1 << t)))
+        return 1;
+
+    const int *group = layout->group(g);
+    mask_t missing = mask_all(layout->dim) & ~board.used[g];
+    while(missing)
+    {
+        mask_t bit = missing & -missing;
+        missing &= missing - 1;
+
+        // groups shared by every cell the value can go in
+        int common[3] = {-1, -1, -1};
+        int seen = 0;
+        for(int k = 0; k < layout->dim; k++)
+        {
+            if(!(board.cand[group[k]] & bit))
+                continue;
+            const int *cg = layout->groups_of(group[k]);
+            for(int u = 0; u < 3; u++)
+            {
+                if(!seen)
+                    common[u] = cg[u];
+                else if(cg[u] != common[u])
+                    common[u] = -1;
+            }
+            seen = 1;
+        }
+
+        for(int u = 0; u < 3; u++)
+        {
+            // a nonet points along a row or col, a row or col into a nonet
+            if(u == type || common[u] < 0 || (type != 2 && u != 2))
+                continue;
+
+            const int *other = layout->group(common[u]);
+            long before = changes;
+            for(int k = 0; k < layout->dim; k++)
+            {
+                int c = other[k];
+                if(layout->groups_of(c)[type] == g)
+                    continue;
+                if(!reduce(board, c, bit))
+                    return 0;
+            }
+            if(changes != before)
+                counts[t]++;
+        }
+    }
+    return 1;
+}
+
+/*
+ * fish()
+ *          Description: X-Wing (n = 2) and Swordfish (n = 3) for one value.
+ *                       If the places left for the value in n rows all lie
+ *                       in the same n cols, the value must be in those cols
+ *                       within those rows, so it is removed from the rest of
+ *                       the cols. The same is tried with rows and cols
+ *                       swapped.
+ *          Input: board -> board to apply tactic to
+ *                 v -> value
+ *                 n -> number of lines, 2 or 3
+ *          Output: returns 0 if a contradiction was found, 1 otherwise
+ *          Calls: find_subset(), reduce()
+ */
+
+int Propagator::fish(Board &board, int v, int n)
+{
+    int t = n == 2 ? X_WING : SWORDFISH;
+    mask_t bit = mask_bit(v);
+    int ok = 1;
+
+    // base 0 uses rows as the base lines and cols as the cover,
+    // base 1 the other way around
+    for(int base = 0; ok && base < 2; base++)
+    {
+        int lines[MAX_DIM];
+        mask_t where[MAX_DIM];
+        int m = 0;
+        for(int i = 0; i < layout->dim; i++)
+        {
+            int g = 3 * i + base;
+            if(board.used[g] & bit)
+                continue;
+            const int *group = layout->group(g);
+            mask_t pos = 0;
+            for(int k = 0; k < layout->dim; k++)
+            {
+                if(board.cand[group[k]] & bit)
+                    pos |= (mask_t)1 << k;
+            }
+            lines[m] = i;
+            where[m] = pos;
+            m++;
+        }
+        if(m <= n)
+            continue;
+
+        auto found = [&](mask_t picked, mask_t cover) -> int
+        {
+            mask_t in_base = 0;
+            for(int i = 0; i < m; i++)
+            {
+                if((picked >> i) & 1)
+                    in_base |= (mask_t)1 << lines[i];
+            }
+
+            // cell k of a cover line lies on base line k
+            long before = changes;
+            while(cover)
+            {
+                int j = mask_lowest(cover) - 1;
+                cover &= cover - 1;
+                const int *group = layout->group(3 * j + 1 - base);
+                for(int k = 0; k < layout->dim; k++)
+                {
+                    if((in_base >> k) & 1)
+                        continue;
+                    if(!reduce(board, group[k], bit))
+                    {
+                        ok = 0;
+                        return 1;
+                    }
+                }
+            }
+            if(changes == before)
+                return 0;
+            counts[t]++;
+            return 1;
+        };
+        find_subset(where, m, n, 0, 0, 0, 0, found);
+    }
+    return ok;
+}
+
+/*
+ * merge()
+ *          Description: Adds the tactic counters and Stats of another
+ *                       Propagator, e.g. one owned by a thread, to this one.
+ *          Input: other -> Propagator to add
+ *          Output: None
+ *          Calls: None
+ */
+
+void Propagator::merge(const Propagator &other)
+{
+    for(int t = 0; t < NUM_TACTICS; t++)
+        counts[t] += other.counts[t];
+    stats.merge(other.stats);
+}
+
+/*
+ * report()
+ *          Description: Prints how often each tactic that is turned on made
+ *                       progress.
+ *          Input: out -> where to print
+ *          Output: None
+ *          Calls: None
+ */
+
+void Propagator::report(FILE *out)
+{
+    fprintf(out, "Tactics:\n");
+    for(int t = 0; t < NUM_TACTICS; t++)
+    {
+        if(t > HIDDEN_SINGLE && !(tactics & (1 << t)))
+            continue;
+        fprintf(out, "\t%-14s %ld\n", tactic_names[t], counts[t]);
+    }
+}
+
+/*
+ * parse_tactics()
+ *          Description: Converts a list of tactic names such as
+ *                       "naked_pair,x_wing" to the bits of
+ *                       Propagator::tactics. "all" turns on every optional
+ *                       tactic.
+ *          Input: list -> comma separated names
+ *          Output: the bits, -1 if a name is not known
+ *          Calls: None
+ */
+
+int parse_tactics(const char *list)
+{
+    int bits = 0;
+    string names(list);
+    size_t start = 0;
+    while(start <= names.size())
+    {
+        size_t end = names.find(',', start);
+        if(end == string::npos)
+            end = names.size();
+        string name = names.substr(start, end - start);
+        start = end + 1;
+
+        if(name == "all")
+        {
+            bits |= TACTICS_ALL;
+            continue;
+        }
+
+        int t = HIDDEN_SINGLE + 1;
+        while(t < NUM_TACTICS && name != Propagator::tactic_names[t])
+            t++;
+        if(t == NUM_TACTICS)
+            return -1;
+        bits |= 1 << t;
+    }
+    return bits;
+}
@@ -0,0 +1,588 @@
+/*
+ * Author: Luke Vandecasteele
+ *
+ * Credits: Matthew Trappert, Dr. Jee W. Choi, Class notes, and other sources
+ *          listed in final report.
+ *
+ * Date Created: 10/16/2026
+ * Last Modified: 10/17/2026
+ *
+ * Description: Final project for CIS 431 at the University of Oregon Fall
+ *              2021. Implementation of the PuzzleReader class, which parses
+ *              puzzle files in place and hands out views of each puzzle.
+ * Notes:
+ *       1. See header.h for all class methods and variables.
+ *       2. All methods contain headers for individual usage and description.
+ *       3. Regular files are memory mapped. Pipes and stdin are read in
+ *          blocks, and a block is only freed by release(), so views stay
+ *          valid until the caller says it is done with them.
+ *       4. Boards up to 25x25 have a character per cell. Larger ones are
+ *          written as whitespace separated numbers, which are read for any
+ *          size, up to MAX_DIM.
+ *       5. Packed files (see packed.cc) are recognized by their header and
+ *          hand out one view per record.
+ *
+ */
+
+#include <ctype.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "header.h"
+
+// size of a block read from a pipe
+#define READ_BLOCK (1 << 22)
+// largest board with one character per cell, the letters run out past
+// it so larger ones must be numbers
+#define CHAR_LIMIT TOKEN_DIM
+
+/*
+ * decode_table()
+ *          Description: Returns the 256 entry lookup table that maps a file
+ *                       character to a value for one dimension, built from
+ *                       decode_value() the first time it is asked for.
+ *          Input: dim -> dimension of the puzzle, at most CHAR_LIMIT
+ *          Output: table of values, -1 for empty squares and 0 for
+ *                  characters that are not valid
+ *          Calls: decode_value()
+ */
+
+const int8_t* decode_table(int dim)
+{
+    static int8_t tables[CHAR_LIMIT + 1][256];
+    static atomic<int> built[CHAR_LIMIT + 1];
+
+    // the release store publishes the table to every thread whose
+    // acquire load sees the flag set
+    if(!built[dim].load(memory_order_acquire))
+    {
+        #pragma omp critical(decode_table)
+        {
+            if(!built[dim].load(memory_order_relaxed))
+            {
+                for(int ch = 0; ch < 256; ch++)
+                    tables[dim][ch] = (int8_t)decode_value((char)ch, dim);
+                built[dim].store(1, memory_order_release);
+            }
+        }
+    }
+    return tables[dim];
+}
+
+/*
+ * decode_cells()
+ *          Description: Converts a run of file characters to values with a
+ *                       table lookup. The loop has no branches so the
+ *                       compiler is free to unroll and vectorize it.
+ *          Input: src -> characters to convert
+ *                 n -> number of characters
+ *                 table -> table from decode_table()
+ *                 val -> where to store the values
+ *          Output: returns 1 if every character was valid, 0 otherwise
+ *          Calls: None
+ */
+
+int decode_cells(const char *src, int n, const int8_t *table, int8_t *val)
+{
+    int bad = 0;
+    for(int i = 0; i < n; i++)
+    {
+        int8_t v = table[(uint8_t)src[i]];
+        bad |= (v == 0);
+        val[i] = v;
+    }
+    return !bad;
+}
+
+/*
+ * decode_tokens()
+ *          Description: Converts whitespace separated numbers to values. 0
+ *                       or '.' marks an empty square.
+ *          Input: src -> text of the puzzle, line endings included
+ *                 len -> length of the text
+ *                 dim -> dimension of the puzzle
+ *                 val -> where to store dim * dim values
+ *          Output: returns 1 if there were exactly dim * dim valid numbers,
+ *                  0 otherwise
+ *          Calls: None
+ */
+
+int decode_tokens(const char *src, size_t len, int dim, int8_t *val)
+{
+    const char *p = src;
+    const char *end = src + len;
+    int cells = dim * dim;
+    int n = 0;
+    for(;;)
+    {
+        while(p < end && isspace((unsigned char)*p))
+            p++;
+        if(p == end)
+            break;
+        if(n == cells)
+            return 0;
+
+        int v = 0;
+        const char *digits = p;
+        if(*p == '.')
+            p++;
+        else
+        {
+            // a few digits are plenty, more can only be out of range
+            while(p < end && p - digits < 4 && *p >= '0' && *p <= '9')
+                v = v * 10 + (*p++ - '0');
+            if(p == digits || v > dim)
+                return 0;
+        }
+        if(p < end && !isspace((unsigned char)*p))
+            return 0;
+        val[n++] = v ? (int8_t)v : -1;
+    }
+    return n == cells;
+}
+
+// a line holding a space or tab is a row (or puzzle) of numbers
+static int has_space(const char *text, size_t n)
+{
+    return memchr(text, ' ', n) != NULL || memchr(text, '\t', n) != NULL;
+}
+
+// number of whitespace separated tokens in a line
+static size_t count_tokens(const char *text, size_t n)
+{
+    size_t count = 0;
+    for(size_t i = 0; i < n; i++)
+        count += !isspace((unsigned char)text[i]) &&
+                 (i == 0 || isspace((unsigned char)text[i - 1]));
+    return count;
+}
+
+/*
+ * line_puzzle()
+ *          Description: Finds the format and dimension of a puzzle given on
+ *                       one line, as characters or as whitespace separated
+ *                       numbers.
+ *          Input: text -> the line, without its line ending
+ *                 n -> length of the line
+ *                 view -> filled in with the puzzle, view.dim is 0 if the
+ *                         line is not one
+ *          Output: None
+ *          Calls: has_space(), count_tokens(), board_dim()
+ */
+
+void line_puzzle(const char *text, size_t n, PuzzleView &view)
+{
+    view.data = text;
+    view.len = n;
+    view.stride = 0;
+    view.dim = 0;
+    view.numeric = 0;
+    view.packed = 0;
+
+    if(has_space(text, n))
+    {
+        view.numeric = 1;
+        view.dim = board_dim(count_tokens(text, n));
+        return;
+    }
+    view.dim = board_dim(n);
+    if(view.dim > CHAR_LIMIT)
+        view.dim = 0;
+    view.stride = view.dim;
+}
+
+// Constructor
+PuzzleReader::PuzzleReader()
+{
+    fd = -1;
+    map = NULL;
+    map_len = 0;
+    buf = NULL;
+    len = 0;
+    pos = 0;
+    mark = 0;
+    eof = 1;
+    packed = 0;
+}
+
+// Destructor
+PuzzleReader::~PuzzleReader()
+{
+    close();
+}
+
+/*
+ * open()
+ *          Description: Opens a puzzle file. Regular files are mapped into
+ *                       memory, anything else (e.g. a pipe) is read in
+ *                       blocks as it is parsed. Packed files are only read
+ *                       when mapped.
+ *          Input: file -> path of the file, "-" for stdin
+ *          Output: returns 1 on success, 0 if the file could not be opened
+ *                  or is a packed file this solver can not read
+ *          Calls: packed_header()
+ */
+
+int PuzzleReader::open(const char *file)
+{
+    close();
+    if(strcmp(file, "-") == 0)
+        fd = dup(0);
+    else
+        fd = ::open(file, O_RDONLY);
+    if(fd < 0)
+        return 0;
+
+    struct stat st;
+    if(fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        void *p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(p != MAP_FAILED)
+        {
+            madvise(p, st.st_size, MADV_SEQUENTIAL);
+            map = (char *)p;
+            map_len = st.st_size;
+            buf = map;
+            len = map_len;
+            pos = mark = 0;
+            eof = 1;
+
+            // records start right after a packed header
+            packed = packed_header(map, map_len, header);
+            if(packed)
+                pos = sizeof(PackedHeader);
+            else if(map_len >= 4 && memcmp(map, packed_magic, 4) == 0)
+            {
+                close();
+                return 0;
+            }
+            return 1;
+        }
+    }
+
+    // streaming fallback
+    eof = 0;
+    pos = mark = len = 0;
+    buf = NULL;
+    return 1;
+}
+
+/*
+ * close()
+ *          Description: Unmaps or frees everything the reader holds. All
+ *                       views become invalid.
+ *          Input: None
+ *          Output: None
+ *          Calls: release()
+ */
+
+void PuzzleReader::close()
+{
+    release();
+    if(map)
+        munmap(map, map_len);
+    else
+        free(buf);
+    map = NULL;
+    buf = NULL;
+    len = pos = mark = 0;
+    if(fd >= 0)
+        ::close(fd);
+    fd = -1;
+    eof = 1;
+    packed = 0;
+}
+
+/*
+ * release()
+ *          Description: Called once the views handed out so far are no
+ *                       longer used, so blocks already parsed past can be
+ *                       freed.
+ *          Input: None
+ *          Output: None
+ *          Calls: None
+ */
+
+void PuzzleReader::release()
+{
+    for(unsigned int i = 0; i < retired.size(); i++)
+        free(retired[i]);
+    retired.clear();
+}
+
+/*
+ * refill()
+ *          Description: Streaming only. Moves the unparsed tail of the
+ *                       current block, starting at the puzzle being read
+ *                       (mark), into a new, larger block and reads more
+ *                       input after it. The old block is kept until
+ *                       release() since views may still point into it.
+ *          Input: None
+ *          Output: returns 1 if more input was read, 0 at the end of input
+ *          Calls: None
+ */
+
+int PuzzleReader::refill()
+{
+    if(eof)
+        return 0;
+
+    size_t tail = len - mark;
+    size_t cap = tail + READ_BLOCK;
+    char *block = (char *)malloc(cap);
+    if(block == NULL)
+        throw bad_alloc();
+    if(tail)
+        memcpy(block, buf + mark, tail);
+    if(buf)
+        retired.push_back(buf);
+    buf = block;
+    pos -= mark;
+    len = tail;
+    mark = 0;
+
+    while(len < cap)
+    {
+        ssize_t n = read(fd, buf + len, cap - len);
+        if(n <= 0)
+        {
+            eof = 1;
+            break;
+        }
+        len += n;
+    }
+    return 1;
+}
+
+/*
+ * line()
+ *          Description: Finds the line starting at pos, reading more input
+ *                       if the line is not complete yet.
+ *          Input: start -> set to the offset of the line in buf
+ *                 end -> set to the offset just past the line's characters
+ *                        (line endings excluded)
+ *          Output: returns 1 if a line was found, 0 at the end of input
+ *          Calls: refill()
+ */
+
+int PuzzleReader::line(size_t &start, size_t &end)
+{
+    for(;;)
+    {
+        const char *nl = NULL;
+        if(pos < len)
+            nl = (const char *)memchr(buf + pos, '\n', len - pos);
+        if(nl != NULL || (eof && pos < len))
+        {
+            start = pos;
+            end = nl ? nl - buf : len;
+            pos = nl ? end + 1 : len;
+            if(end > start && buf[end - 1] == '\r')
+                end--;
+            return 1;
+        }
+        if(!refill())
+            return 0;
+    }
+}
+
+/*
+ * next()
+ *          Description: Finds the next puzzle. A line holding only a number
+ *                       starts a puzzle in the single puzzle format (the
+ *                       dimension, then one line per row); any other non
+ *                       empty line is a whole puzzle. Cells are single
+ *                       characters, or whitespace separated numbers when the
+ *                       line (or the first row) holds a space or tab.
+ *                       Nothing is copied, the view points at the puzzle's
+ *                       first character and gives the distance between its
+ *                       rows, or for numbers the length of all of them. In a
+ *                       packed file every record is a puzzle.
+ *          Input: view -> filled in with the puzzle. view.dim is 0 if the
+ *                         puzzle is malformed, and then data and len cover
+ *                         its first line.
+ *          Output: returns 1 if a puzzle was found, 0 at the end of input
+ *          Calls: line(), line_puzzle(), has_space()
+ */
+
+int PuzzleReader::next(PuzzleView &view)
+{
+    size_t start, end;
+
+    if(packed)
+    {
+        if(len - pos < header.record)
+            return 0;
+        view.data = buf + pos;
+        view.len = header.record;
+        view.dim = header.dim;
+        view.stride = 0;
+        view.numeric = 0;
+        view.packed = 1;
+        pos += header.record;
+        return 1;
+    }
+
+    // skip blank lines
+    mark = pos;
+    do
+    {
+        if(!line(start, end))
+            return 0;
+    } while(end == start);
+
+    // everything from here on is measured from the puzzle's first line,
+    // since refill() may move it to a new block
+    mark = start;
+    size_t n = end - start;
+    const char *text = buf + start;
+
+    line_puzzle(text, n, view);
+
+    // one puzzle per line
+    int number = n <= 3;
+    for(size_t i = 0; i < n; i++)
+        number &= text[i] >= '0' && text[i] <= '9';
+    if(!number)
+        return 1;
+    view.dim = 0;
+    view.stride = 0;
+
+    // single puzzle format, the rows have to follow with the same
+    // line endings so they can be reached with one stride
+    int dim = atoi(string(text, n).c_str());
+    if(!board_dim((size_t)dim * dim))
+        return 1;
+
+    size_t first = 0;
+    size_t stride = 0;
+    size_t prev = 0;
+    int numeric = 0;
+    int rows = 0;
+    for(; rows < dim; rows++)
+    {
+        if(!line(start, end))
+            break;
+
+        size_t offset = start - mark;
+        if(rows == 0)
+        {
+            first = offset;
+            numeric = has_space(buf + start, end - start);
+        }
+
+        // rows of numbers are decoded as one run of text,
+        // prev is where the last of them ends
+        if(numeric)
+        {
+            prev = end - mark;
+            continue;
+        }
+
+        if(end - start != (size_t)dim || dim > CHAR_LIMIT)
+            break;
+        if(rows == 1)
+            stride = offset - first;
+        else if(rows > 1 && offset - prev != stride)
+            break;
+        prev = offset;
+    }
+
+    if(rows != dim)
+    {
+        view.data = buf + start;
+        view.len = end - start;
+        return 1;
+    }
+
+    view.data = buf + mark + first;
+    view.dim = dim;
+    if(numeric)
+    {
+        view.numeric = 1;
+        view.len = prev - first;
+        return 1;
+    }
+    view.stride = dim == 1 ? 1 : stride;
+    view.len = (size_t)dim * dim;
+    return 1;
+}
+
+/*
+ * skip()
+ *          Description: Skips puzzles, e.g. to reach one by its index. In a
+ *                       packed file this only moves to the record's offset,
+ *                       text has to be parsed up to it.
+ *          Input: n -> number of puzzles to skip
+ *          Output: number of puzzles skipped, less than n at the end of input
+ *          Calls: next(), release()
+ */
+
+long PuzzleReader::skip(long n)
+{
+    if(packed)
+    {
+        long left = (len - pos) / header.record;
+        n = min(n, left);
+        pos += (size_t)n * header.record;
+        return n;
+    }
+
+    PuzzleView view;
+    long skipped = 0;
+    while(skipped < n && next(view))
+    {
+        skipped++;
+        release();
+    }
+    return skipped;
+}
+
+/*
+ * decode()
+ *          Description: Converts the characters, or the packed record, of a
+ *                       puzzle into values.
+ *          Input: view -> puzzle from next()
+ *                 val -> where to store dim * dim values
+ *          Output: returns 1 if every character was valid, 0 otherwise
+ *          Calls: decode_table(), decode_cells(), decode_tokens(),
+ *                 unpack_cells()
+ */
+
+int PuzzleReader::decode(const PuzzleView &view, int8_t *val)
+{
+    if(view.packed)
+        return unpack_cells((const uint8_t *)view.data, view.dim,
+                            header.flags, val);
+    if(view.numeric)
+        return decode_tokens(view.data, view.len, view.dim, val);
+
+    const int8_t *table = decode_table(view.dim);
+    if(view.stride == view.dim)
+        return decode_cells(view.data, view.dim * view.dim, table, val);
+
+    int ok = 1;
+    for(int r = 0; r < view.dim; r++)
+        ok &= decode_cells(view.data + (size_t)r * view.stride, view.dim,
+                           table, val + r * view.dim);
+    return ok;
+}
+
+/*
+ * board_dim()
+ *          Description: Finds the dimension of a puzzle given on one line.
+ *          Input: len -> number of characters, or numbers, in the line
+ *          Output: dimension, or 0 if the length is not that of a puzzle
+ *          Calls: None
+ */
+
+int board_dim(size_t len)
+{
+    int dim = (int)(sqrt((double)len) + 0.5);
+    int box = (int)(sqrt((double)dim) + 0.5);
+    if(dim < 1 || (size_t)dim * dim != len || box * box != dim ||
+       dim > MAX_DIM)
+        return 0;
+    return dim;
+}
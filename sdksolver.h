@@ -0,0 +1,131 @@
+/*
+ * Author: Luke Vandecasteele
+ *
+ * Credits: Matthew Trappert, Dr. Jee W. Choi, Class notes, and other sources
+ *          listed in final report.
+ *
+ * Date Created: 10/17/2026
+ * Last Modified: 10/17/2026
+ *
+ * Description: Final project for CIS 431 at the University of Oregon Fall
+ *              2021. Public header of libsdksolver, the solver as a library
+ *              with a C and a C++ interface.
+ * Notes:
+ *       1. This is the only header a program linking libsdksolver.a or
+ *          libsdksolver.so needs, it does not include header.h.
+ *       2. Puzzles are passed as dim * dim bytes in row order, 0 for an
+ *          empty square and 1 to dim for a value.
+ *       3. A context keeps one solver per thread and dimension alive from
+ *          call to call, so solving puzzles of the same size again does not
+ *          allocate. Batches run on the OpenMP team, which stays alive
+ *          between calls. A context must not be used by two threads at once.
+ *       4. A context may cache solutions, so that a puzzle that is a
+ *          relabeling, transpose, or row and col shuffle of one it solved
+ *          before is not solved again. The cache is only used by the
+ *          serial engine.
+ *
+ */
+
+#ifndef SDKSOLVER_H_
+#define SDKSOLVER_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* engines */
+#define SDK_ENGINE_SERIAL 0
+/* the solver compiled for the box size, serial when there is none */
+#define SDK_ENGINE_FIXED 1
+
+/* results of sdk_solve() */
+#define SDK_SOLVED 1
+#define SDK_NO_SOLUTION 0
+#define SDK_BAD_PUZZLE -1
+/* out of memory */
+#define SDK_ERROR -2
+
+typedef struct sdk_options
+{
+    int dim;        /* dimension of the puzzles, e.g. 9 */
+    int engine;     /* SDK_ENGINE_SERIAL or SDK_ENGINE_FIXED */
+    int tactics;    /* optional tactics, bit (1 << Tactic) as in header.h */
+    int threads;    /* threads for sdk_solve_batch(), 0 for all */
+} sdk_options;
+
+typedef struct sdk_context sdk_context;
+
+/* options for dim with the serial engine, no optional tactics and all
+   threads */
+void sdk_options_init(sdk_options *options, int dim);
+
+sdk_context *sdk_context_new(void);
+void sdk_context_free(sdk_context *ctx);
+
+/* keeps the solutions of up to entries recent puzzles, 0 for no cache,
+   returns SDK_ERROR if memory ran out and 0 otherwise */
+int sdk_context_cache(sdk_context *ctx, long entries);
+
+/* solves one puzzle into out, which may be the same buffer as in,
+   returns SDK_SOLVED, SDK_NO_SOLUTION, SDK_BAD_PUZZLE, or SDK_ERROR */
+int sdk_solve(sdk_context *ctx, const uint8_t *in, uint8_t *out,
+              const sdk_options *options);
+
+/* solves count puzzles laid out one after another, one puzzle per thread,
+   and returns how many were solved. Unsolved puzzles are copied to out
+   unchanged. status, if not NULL, gets the sdk_solve() result of each.
+   Returns SDK_ERROR if memory ran out for any puzzle, whose status is then
+   SDK_ERROR. */
+long sdk_solve_batch(sdk_context *ctx, const uint8_t *in, uint8_t *out,
+                     long count, const sdk_options *options,
+                     int8_t *status);
+
+#ifdef __cplusplus
+}
+
+#include <vector>
+
+class Sudoku;
+class SolveCache;
+
+typedef sdk_options SolverOptions;
+
+/*
+ * SolverContext is the C++ side of the library. It holds a solver for
+ * each thread that has solved a puzzle, rebuilt only when the dimension
+ * changes.
+ */
+class SolverContext
+{
+public:
+
+    // solvers[t] is used by OpenMP thread t
+    std::vector<Sudoku*> solvers;
+    // shared by every solver, NULL for none
+    SolveCache *cache;
+
+    // Constructor
+    SolverContext();
+    // Destructor
+    ~SolverContext();
+
+    int solve(const uint8_t *in, uint8_t *out, const SolverOptions &options);
+    long solve_batch(const uint8_t *in, uint8_t *out, long count,
+                     const SolverOptions &options, int8_t *status = NULL);
+    void use_cache(long entries);
+
+    // helper functions
+    Sudoku* solver(int t, int dim);
+    int solve_with(Sudoku *puzzle, const uint8_t *in, uint8_t *out,
+                   const SolverOptions &options);
+
+private:
+    SolverContext(const SolverContext &);
+    SolverContext& operator=(const SolverContext &);
+};
+
+#endif
+
+#endif // SDKSOLVER_H_
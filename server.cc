@@ -0,0 +1,505 @@
+/*
+ * Author: Luke Vandecasteele
+ *
+ * Credits: Matthew Trappert, Dr. Jee W. Choi, Class notes, and other sources
+ *          listed in final report.
+ *
+ * Date Created: 10/17/2026
+ * Last Modified: 10/17/2026
+ *
+ * Description: Final project for CIS 431 at the University of Oregon Fall
+ *              2021. Implementation of the Server class, the solver as a
+ *              daemon answering puzzles on stdin or a Unix domain socket.
+ * Notes:
+ *       1. See header.h for all class methods and variables.
+ *       2. All methods contain headers for individual usage and description.
+ *       3. Requests and replies are frames, see FrameHeader in header.h. A
+ *          request holds one puzzle as one line of text, characters or
+ *          whitespace separated numbers as in a batch file, and its reply
+ *          the solution in the same format, or the puzzle as it was sent
+ *          if it was not solved. Headers are in the cpu's byte order.
+ *       4. A client may send any number of requests without waiting. With
+ *          more than one solver thread the replies come back in the order
+ *          the puzzles are solved, the id tells them apart.
+ *       5. The solvers, their boards, and spent requests are kept from one
+ *          request to the next, a request only allocates while more are in
+ *          flight than ever before.
+ *       6. Serving stdin ends at its end, once every reply is written. A
+ *          socket is served until SIGINT or SIGTERM.
+ *
+ */
+
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "header.h"
+
+// bytes read from a connection at a time
+#define READ_BLOCK 65536
+
+// a client and the bytes it sent that do not make a whole frame yet
+struct Connection
+{
+    int in;
+    int out;
+    vector<char> buf;
+    // held by the reader and by every request in flight
+    atomic<int> refs;
+    mutex write_lock;
+
+    Connection(int i, int o) : in(i), out(o), refs(1) {}
+};
+
+// one puzzle to solve, reused once its reply is written
+struct Request
+{
+    Connection *conn;
+    uint32_t id;
+    uint64_t received;
+    vector<char> text;
+};
+
+// set by SIGINT and SIGTERM
+static volatile sig_atomic_t stopping = 0;
+
+static void stop_serving(int)
+{
+    stopping = 1;
+}
+
+// writes all of a reply, giving up if the client has gone
+static void write_all(int fd, const char *data, size_t n)
+{
+    while(n)
+    {
+        ssize_t w = write(fd, data, n);
+        if(w < 0 && errno == EINTR)
+            continue;
+        if(w <= 0)
+            return;
+        data += w;
+        n -= w;
+    }
+}
+
+// Constructor
+Server::Server()
+    : served(0), solved(0)
+{
+    listen_fd = -1;
+    path = NULL;
+    done = 0;
+    fixed = 0;
+    workers = 0;
+    seconds = 0.0;
+}
+
+// Destructor
+Server::~Server()
+{
+    for(unsigned int i = 0; i < connections.size(); i++)
+    {
+        if(listen_fd >= 0)
+            ::close(connections[i]->in);
+        delete connections[i];
+    }
+    for(unsigned int i = 0; i < queue.size(); i++)
+        delete queue[i];
+    for(unsigned int i = 0; i < spare.size(); i++)
+        delete spare[i];
+    if(listen_fd >= 0)
+    {
+        ::close(listen_fd);
+        unlink(path);
+    }
+}
+
+/*
+ * open()
+ *          Description: Sets up where requests come from: stdin, with the
+ *                       replies on stdout, or a Unix domain socket that
+ *                       clients connect to. A socket left at the path by an
+ *                       earlier server is replaced, any other file is not.
+ *          Input: file -> "-" for stdin, otherwise the path of the socket
+ *          Output: returns 1 on success, 0 if the socket could not be made
+ *          Calls: None
+ */
+
+int Server::open(const char *file)
+{
+    if(strcmp(file, "-") == 0)
+    {
+        connections.push_back(new Connection(0, 1));
+        return 1;
+    }
+
+    struct sockaddr_un addr;
+    if(strlen(file) >= sizeof(addr.sun_path))
+        return 0;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, file);
+
+    struct stat st;
+    if(stat(file, &st) == 0 && S_ISSOCK(st.st_mode))
+        unlink(file);
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(listen_fd < 0)
+        return 0;
+    if(bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+       listen(listen_fd, SOMAXCONN) < 0)
+    {
+        ::close(listen_fd);
+        listen_fd = -1;
+        return 0;
+    }
+    path = file;
+    return 1;
+}
+
+/*
+ * serve()
+ *          Description: Answers requests until the input ends or a signal
+ *                       stops the server. Thread 0 reads, the others solve,
+ *                       so the team is one thread larger than the number of
+ *                       solvers. The signals are blocked everywhere but in
+ *                       the reader's ppoll(), which they interrupt.
+ *          Input: None
+ *          Output: None
+ *          Calls: poll_input(), work()
+ */
+
+void Server::serve()
+{
+    uint64_t start = ReadClock();
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = stop_serving;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    sigset_t stops, old;
+    sigemptyset(&stops);
+    sigaddset(&stops, SIGINT);
+    sigaddset(&stops, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stops, &old);
+
+    workers = omp_get_max_threads();
+    if(context.solvers.size() < (size_t)workers)
+        context.solvers.resize(workers, NULL);
+
+    #pragma omp parallel num_threads(workers + 1)
+    {
+        int tid = omp_get_thread_num();
+        if(tid == 0)
+        {
+            poll_input();
+            // no thread to solve with, answer what was read
+            if(omp_get_num_threads() == 1)
+                work(0);
+        }
+        else
+            work(tid - 1);
+    }
+
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    seconds = ElapsedTime(ReadClock() - start);
+}
+
+/*
+ * poll_input()
+ *          Description: The reader's loop. Waits for new clients and for
+ *                       requests on every connection, then tells the
+ *                       solvers to finish the queue and stop.
+ *          Input: None
+ *          Output: None
+ *          Calls: read_frames(), release()
+ */
+
+void Server::poll_input()
+{
+    vector<struct pollfd> fds;
+    sigset_t none;
+    sigemptyset(&none);
+
+    while(!stopping)
+    {
+        fds.clear();
+        if(listen_fd >= 0)
+        {
+            struct pollfd fd = {listen_fd, POLLIN, 0};
+            fds.push_back(fd);
+        }
+        else if(connections.empty())
+            break;
+        size_t first = fds.size();
+        for(unsigned int i = 0; i < connections.size(); i++)
+        {
+            struct pollfd fd = {connections[i]->in, POLLIN, 0};
+            fds.push_back(fd);
+        }
+
+        if(ppoll(fds.data(), fds.size(), NULL, &none) < 0)
+        {
+            if(errno == EINTR)
+                continue;
+            break;
+        }
+
+        if(listen_fd >= 0 && (fds[0].revents & POLLIN))
+        {
+            int fd = accept(listen_fd, NULL, NULL);
+            if(fd >= 0)
+                connections.push_back(new Connection(fd, fd));
+        }
+
+        // backwards so closing one does not move the ones left to read
+        for(size_t i = fds.size(); i-- > first;)
+        {
+            if(!fds[i].revents)
+                continue;
+            Connection *conn = connections[i - first];
+            if(!read_frames(conn))
+            {
+                connections.erase(connections.begin() + (i - first));
+                release(conn);
+            }
+        }
+    }
+
+    {
+        lock_guard<mutex> guard(queue_lock);
+        done = 1;
+    }
+    ready.notify_all();
+}
+
+/*
+ * read_frames()
+ *          Description: Reads what a client sent and queues every whole
+ *                       request in it, keeping the start of the next one.
+ *          Input: conn -> connection with something to read
+ *          Output: returns 0 if the connection has ended or sent a frame
+ *                  longer than FRAME_LIMIT, 1 otherwise
+ *          Calls: None
+ */
+
+int Server::read_frames(Connection *conn)
+{
+    char block[READ_BLOCK];
+    ssize_t n = read(conn->in, block, sizeof(block));
+    if(n < 0 && errno == EINTR)
+        return 1;
+    if(n <= 0)
+        return 0;
+
+    vector<char> &buf = conn->buf;
+    buf.insert(buf.end(), block, block + n);
+
+    size_t pos = 0;
+    while(buf.size() - pos >= sizeof(FrameHeader))
+    {
+        FrameHeader frame;
+        memcpy(&frame, &buf[pos], sizeof(frame));
+        if(frame.length > FRAME_LIMIT)
+            return 0;
+        if(buf.size() - pos - sizeof(frame) < frame.length)
+            break;
+
+        Request *request = NULL;
+        {
+            lock_guard<mutex> guard(queue_lock);
+            if(!spare.empty())
+            {
+                request = spare.back();
+                spare.pop_back();
+            }
+        }
+        if(request == NULL)
+            request = new Request;
+
+        const char *text = &buf[pos + sizeof(frame)];
+        request->conn = conn;
+        request->id = frame.id;
+        request->received = ReadClock();
+        request->text.assign(text, text + frame.length);
+        conn->refs++;
+        {
+            lock_guard<mutex> guard(queue_lock);
+            queue.push_back(request);
+        }
+        ready.notify_one();
+        pos += sizeof(frame) + frame.length;
+    }
+    buf.erase(buf.begin(), buf.begin() + pos);
+    return 1;
+}
+
+/*
+ * work()
+ *          Description: A solver's loop. Takes requests off the queue and
+ *                       writes their replies until the reader is done and
+ *                       the queue is empty.
+ *          Input: t -> number of the solver, from 0
+ *          Output: None
+ *          Calls: answer(), release()
+ */
+
+void Server::work(int t)
+{
+    vector<uint8_t> values;
+    vector<char> out;
+    for(;;)
+    {
+        Request *request;
+        {
+            unique_lock<mutex> guard(queue_lock);
+            while(queue.empty() && !done)
+                ready.wait(guard);
+            if(queue.empty())
+                break;
+            request = queue.front();
+            queue.pop_front();
+        }
+
+        answer(t, request, values, out);
+        Connection *conn = request->conn;
+        {
+            lock_guard<mutex> guard(conn->write_lock);
+            write_all(conn->out, out.data(), out.size());
+        }
+        release(conn);
+
+        lock_guard<mutex> guard(queue_lock);
+        spare.push_back(request);
+    }
+}
+
+/*
+ * answer()
+ *          Description: Solves the puzzle of a request and builds its reply.
+ *                       A line ending sent with the puzzle is ignored.
+ *          Input: t -> number of the solver
+ *                 request -> request to answer
+ *                 values -> this solver's room for the values of a puzzle
+ *                 out -> filled in with the reply frame
+ *          Output: None
+ *          Calls: line_puzzle(), decode_cells(), decode_tokens(),
+ *                 SolverContext.solver(), SolverContext.solve_with(),
+ *                 encode_value(), encode_tokens()
+ */
+
+void Server::answer(int t, Request *request, vector<uint8_t> &values,
+                    vector<char> &out)
+{
+    const char *text = request->text.data();
+    size_t n = request->text.size();
+    while(n && (text[n - 1] == '\n' || text[n - 1] == '\r'))
+        n--;
+
+    PuzzleView view;
+    line_puzzle(text, n, view);
+    int dim = view.dim;
+    int cells = dim * dim;
+
+    ReplyHeader reply = {SDK_BAD_PUZZLE, 0, 0, 0};
+    Sudoku *puzzle = NULL;
+    if(dim)
+    {
+        puzzle = context.solver(t, dim);
+        Board &board = puzzle->board;
+        int valid;
+        if(view.numeric)
+            valid = decode_tokens(text, n, dim, board.val);
+        else
+            valid = decode_cells(text, cells, decode_table(dim), board.val);
+
+        if(valid)
+        {
+            // solve_with() takes the values as 0 for an empty square
+            values.resize(cells);
+            for(int c = 0; c < cells; c++)
+                values[c] = board.val[c] == -1 ? 0 : board.val[c];
+
+            SolverOptions options;
+            sdk_options_init(&options, dim);
+            options.engine = fixed ? SDK_ENGINE_FIXED : SDK_ENGINE_SERIAL;
+            options.tactics = Propagator::default_tactics;
+            uint64_t start = ReadClock();
+            reply.status = context.solve_with(puzzle, values.data(),
+                                              values.data(), options);
+            reply.solve_ns = ReadClock() - start;
+        }
+    }
+
+    // the solution in the format of the puzzle, anything else goes back
+    // as it came
+    size_t head = sizeof(FrameHeader) + sizeof(ReplyHeader);
+    size_t len = n;
+    if(reply.status == SDK_SOLVED)
+        len = view.numeric ? cells * (token_width(dim) + 1) : cells;
+    out.resize(head + len);
+    char *body = &out[head];
+    if(reply.status != SDK_SOLVED)
+        memcpy(body, text, n);
+    else if(view.numeric)
+        len = encode_tokens(puzzle->board.val, cells, dim, body);
+    else
+    {
+        for(int c = 0; c < cells; c++)
+            body[c] = encode_value(puzzle->board.val[c], dim);
+    }
+    out.resize(head + len);
+
+    served++;
+    solved += reply.status == SDK_SOLVED;
+    FrameHeader frame = {(uint32_t)(sizeof(ReplyHeader) + len), request->id};
+    reply.total_ns = ReadClock() - request->received;
+    memcpy(&out[0], &frame, sizeof(frame));
+    memcpy(&out[sizeof(frame)], &reply, sizeof(reply));
+}
+
+/*
+ * release()
+ *          Description: Drops a hold on a connection, closing it once the
+ *                       reader is done with it and every reply is written.
+ *          Input: conn -> connection to release
+ *          Output: None
+ *          Calls: None
+ */
+
+void Server::release(Connection *conn)
+{
+    if(--conn->refs > 0)
+        return;
+    if(listen_fd >= 0)
+        ::close(conn->in);
+    delete conn;
+}
+
+/*
+ * summary()
+ *          Description: Prints how many requests were answered, and solved.
+ *          Input: out -> where to print the summary
+ *          Output: None
+ *          Calls: None
+ */
+
+void Server::summary(FILE *out)
+{
+    long total = served;
+    long ok = solved;
+    fprintf(out, "Requests: %ld solved: %ld failed: %ld\n",
+            total, ok, total - ok);
+    fprintf(out, "Time serving: %g threads: %d\n", seconds, workers);
+    if(context.cache)
+        context.cache->report(out);
+}
@@ -0,0 +1,214 @@
+/*
+ * Author: Luke Vandecasteele
+ *
+ * Credits: Matthew Trappert, Dr. Jee W. Choi, Class notes, and other sources
+ *          listed in final report.
+ *
+ * Date Created: 10/16/2026
+ * Last Modified: 10/17/2026
+ *
+ * Description: Final project for CIS 431 at the University of Oregon Fall
+ *              2021. Kernels that scan the candidate masks of one group,
+ *              used by elimination() and lone_ranger().
+ * Notes:
+ *       1. All methods contain headers for individual usage and description.
+ *       2. Each kernel has a scalar version and an AVX2 version that gathers
+ *          four cells of the group per step. The AVX2 version is picked once
+ *          at startup if the cpu supports it, so the binary still runs on
+ *          machines without it.
+ *       3. Built with WIDE_MASKS, or for a cpu other than x86, only the
+ *          scalar versions are compiled.
+ *
+ */
+
+#include "header.h"
+
+// the AVX2 kernels gather one 64 bit word per cell
+#if !defined(WIDE_MASKS) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_AVX2
+#include <immintrin.h>
+#endif
+
+/*
+ * group_counts_scalar()
+ *          Description: Accumulates which values appear as a candidate at
+ *                       least once, and at least twice, across the cells of
+ *                       a group.
+ *          Input: cand -> candidate masks of the board
+ *                 group -> cell indices of the group
+ *                 dim -> number of cells in the group
+ *                 once -> set to the values seen at least once
+ *                 twice -> set to the values seen at least twice
+ *          Output: None
+ *          Calls: None
+ */
+
+static void group_counts_scalar(const mask_t *cand, const int *group, int dim,
+                                mask_t &once, mask_t &twice)
+{
+    once = 0;
+    twice = 0;
+    for(int k = 0; k < dim; k++)
+    {
+        mask_t m = cand[group[k]];
+        twice |= once & m;
+        once |= m;
+    }
+}
+
+/*
+ * group_changed_scalar()
+ *          Description: Finds the cells of a group that still have a value
+ *                       used by the group as a candidate.
+ *          Input: cand -> candidate masks of the board
+ *                 group -> cell indices of the group
+ *                 dim -> number of cells in the group
+ *                 used -> values used by the group
+ *          Output: bit k is set if cell k of the group would lose
+ *                  candidates
+ *          Calls: None
+ */
+
+static mask_t group_changed_scalar(const mask_t *cand, const int *group,
+                                   int dim, mask_t used)
+{
+    mask_t changed = 0;
+    for(int k = 0; k < dim; k++)
+        changed |= (mask_t)((cand[group[k]] & used) != 0) << k;
+    return changed;
+}
+
+#ifdef SIMD_AVX2
+/*
+ * group_counts_avx2()
+ *          Description: AVX2 version of group_counts_scalar(). Each of the
+ *                       four lanes keeps its own once and twice masks, which
+ *                       are merged at the end: a value is seen twice if
+ *                       either half saw it twice or both halves saw it.
+ *          Input: see group_counts_scalar()
+ *          Output: None
+ *          Calls: None
+ */
+
+__attribute__((target("avx2")))
+static void group_counts_avx2(const mask_t *cand, const int *group, int dim,
+                              mask_t &once, mask_t &twice)
+{
+    const long long *base = (const long long *)cand;
+    __m256i vonce = _mm256_setzero_si256();
+    __m256i vtwice = _mm256_setzero_si256();
+
+    int k = 0;
+    for(; k + 4 <= dim; k += 4)
+    {
+        __m128i idx = _mm_loadu_si128((const __m128i *)(group + k));
+        __m256i m = _mm256_i32gather_epi64(base, idx, 8);
+        vtwice = _mm256_or_si256(vtwice, _mm256_and_si256(vonce, m));
+        vonce = _mm256_or_si256(vonce, m);
+    }
+
+    uint64_t o[4];
+    uint64_t t[4];
+    _mm256_storeu_si256((__m256i *)o, vonce);
+    _mm256_storeu_si256((__m256i *)t, vtwice);
+
+    mask_t t01 = t[0] | t[1] | (o[0] & o[1]);
+    mask_t t23 = t[2] | t[3] | (o[2] & o[3]);
+    mask_t o01 = o[0] | o[1];
+    mask_t o23 = o[2] | o[3];
+    twice = t01 | t23 | (o01 & o23);
+    once = o01 | o23;
+
+    // cells left over when dim is not a multiple of four
+    for(; k < dim; k++)
+    {
+        mask_t m = cand[group[k]];
+        twice |= once & m;
+        once |= m;
+    }
+}
+
+/*
+ * group_changed_avx2()
+ *          Description: AVX2 version of group_changed_scalar(). Compares
+ *                       four cells at a time and packs the results into the
+ *                       bitmask with movemask.
+ *          Input: see group_changed_scalar()
+ *          Output: see group_changed_scalar()
+ *          Calls: None
+ */
+
+__attribute__((target("avx2")))
+static mask_t group_changed_avx2(const mask_t *cand, const int *group,
+                                 int dim, mask_t used)
+{
+    const long long *base = (const long long *)cand;
+    __m256i vused = _mm256_set1_epi64x((long long)used);
+    __m256i zero = _mm256_setzero_si256();
+    uint64_t changed = 0;
+
+    int k = 0;
+    for(; k + 4 <= dim; k += 4)
+    {
+        __m128i idx = _mm_loadu_si128((const __m128i *)(group + k));
+        __m256i m = _mm256_i32gather_epi64(base, idx, 8);
+        __m256i none = _mm256_cmpeq_epi64(_mm256_and_si256(m, vused), zero);
+        int bits = _mm256_movemask_pd(_mm256_castsi256_pd(none));
+        changed |= (uint64_t)(~bits & 0xf) << k;
+    }
+
+    for(; k < dim; k++)
+        changed |= (uint64_t)((cand[group[k]] & used) != 0) << k;
+    return changed;
+}
+#endif
+
+// kernels picked for this cpu
+typedef void (*counts_fn)(const mask_t *, const int *, int, mask_t &,
+                          mask_t &);
+typedef mask_t (*changed_fn)(const mask_t *, const int *, int, mask_t);
+
+#ifndef SIMD_AVX2
+static const counts_fn counts_kernel = group_counts_scalar;
+static const changed_fn changed_kernel = group_changed_scalar;
+#else
+static int has_avx2()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+static const int use_avx2 = has_avx2();
+static const counts_fn counts_kernel =
+    use_avx2 ? group_counts_avx2 : group_counts_scalar;
+static const changed_fn changed_kernel =
+    use_avx2 ? group_changed_avx2 : group_changed_scalar;
+#endif
+
+/*
+ * group_counts()
+ *          Description: See group_counts_scalar().
+ *          Input: see group_counts_scalar()
+ *          Output: None
+ *          Calls: group_counts_avx2() or group_counts_scalar()
+ */
+
+void group_counts(const mask_t *cand, const int *group, int dim,
+                  mask_t &once, mask_t &twice)
+{
+    counts_kernel(cand, group, dim, once, twice);
+}
+
+/*
+ * group_changed()
+ *          Description: See group_changed_scalar().
+ *          Input: see group_changed_scalar()
+ *          Output: see group_changed_scalar()
+ *          Calls: group_changed_avx2() or group_changed_scalar()
+ */
+
+mask_t group_changed(const mask_t *cand, const int *group, int dim,
+                     mask_t used)
+{
+    return changed_kernel(cand, group, dim, used);
+}
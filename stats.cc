@@ -0,0 +1,122 @@
+/*
+ * Author: Luke Vandecasteele
+ *
+ * Credits: Matthew Trappert, Dr. Jee W. Choi, Class notes, and other sources
+ *          listed in final report.
+ *
+ * Date Created: 10/16/2026
+ * Last Modified: 10/17/2026
+ *
+ * Description: Final project for CIS 431 at the University of Oregon Fall
+ *              2021. Implementation of the Stats counters kept by the
+ *              solvers and the WorkStealer, and their JSON report.
+ * Notes:
+ *       1. See header.h for all class methods and variables.
+ *       2. All methods contain headers for individual usage and description.
+ *       3. Built with NO_STATS the counters are never updated and stay 0,
+ *          the report says so with "counters": false.
+ *
+ */
+
+#include "header.h"
+
+/*
+ * clear()
+ *          Description: Sets every counter back to 0.
+ *          Input: None
+ *          Output: None
+ *          Calls: None
+ */
+
+void Stats::clear()
+{
+    nodes = 0;
+    guesses = 0;
+    backtracks = 0;
+    max_depth = 0;
+    propagations = 0;
+    groups = 0;
+    pushes = 0;
+    pops = 0;
+    steals = 0;
+    peak_queue = 0;
+    wait_ns = 0;
+    quiesce_ns = 0;
+}
+
+/*
+ * merge()
+ *          Description: Adds the counters of another Stats, e.g. one kept by
+ *                       a thread, to this one. Depth, queue size, and
+ *                       quiesce time keep the largest of the two.
+ *          Input: other -> Stats to add
+ *          Output: None
+ *          Calls: None
+ */
+
+void Stats::merge(const Stats &other)
+{
+    nodes += other.nodes;
+    guesses += other.guesses;
+    backtracks += other.backtracks;
+    max_depth = max(max_depth, other.max_depth);
+    propagations += other.propagations;
+    groups += other.groups;
+    pushes += other.pushes;
+    pops += other.pops;
+    steals += other.steals;
+    peak_queue = max(peak_queue, other.peak_queue);
+    wait_ns += other.wait_ns;
+    quiesce_ns = max(quiesce_ns, other.quiesce_ns);
+}
+
+/*
+ * print_json()
+ *          Description: Prints the counters as one JSON object.
+ *          Input: out -> where to print
+ *                 engine -> name of the solver that ran
+ *                 threads -> threads it ran with
+ *                 seconds -> time to solve
+ *                 tactic_counts -> cells filled or reductions made by each
+ *                                  Tactic, NULL if the engine has none
+ *          Output: None
+ *          Calls: None
+ */
+
+void Stats::print_json(FILE *out, const char *engine, int threads,
+                       double seconds, const long *tactic_counts) const
+{
+#ifdef NO_STATS
+    const char *counters = "false";
+#else
+    const char *counters = "true";
+#endif
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"engine\": \"%s\",\n", engine);
+    fprintf(out, "  \"threads\": %d,\n", threads);
+    fprintf(out, "  \"seconds\": %.6f,\n", seconds);
+    fprintf(out, "  \"counters\": %s,\n", counters);
+    fprintf(out, "  \"nodes\": %ld,\n", nodes);
+    fprintf(out, "  \"guesses\": %ld,\n", guesses);
+    fprintf(out, "  \"backtracks\": %ld,\n", backtracks);
+    fprintf(out, "  \"max_depth\": %ld,\n", max_depth);
+    fprintf(out, "  \"propagations\": %ld,\n", propagations);
+    fprintf(out, "  \"groups\": %ld,\n", groups);
+    fprintf(out, "  \"pushes\": %ld,\n", pushes);
+    fprintf(out, "  \"pops\": %ld,\n", pops);
+    fprintf(out, "  \"steals\": %ld,\n", steals);
+    fprintf(out, "  \"peak_queue\": %ld,\n", peak_queue);
+    fprintf(out, "  \"wait_ms\": %.3f,\n", wait_ns / 1e6);
+    fprintf(out, "  \"quiesce_ms\": %.3f,\n", quiesce_ns / 1e6);
+
+    fprintf(out, "  \"tactics\": {");
+    if(tactic_counts)
+    {
+        for(int t = 0; t < NUM_TACTICS; t++)
+            fprintf(out, "%s\"%s\": %ld", t ? ", " : "",
+                    Propagator::tactic_names[t], tactic_counts[t]);
+    }
+    fprintf(out, "}\n");
+    fprintf(out, "}\n");
+}
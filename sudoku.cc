@@ -5,7 +5,7 @@
  *          listed in final report.
  *
  * Date Created: 11/8/2021
- * Last Modified: 12/3/2021
+ * Last Modified: 10/17/2026
  *
  * Description: Final project for CIS 431 at the University of Oregon Fall
  *              2021. Implementation of a serial sudoku solver. 
@@ -18,45 +18,26 @@
 #include "header.h"
 
 // Constructor
-Sudoku::Sudoku(vector<vector<Tile*>> in, int n)
+Sudoku::Sudoku(const Board &in)
+	: board(in)
 {
-	matrix = in;
-	dim = n;
-	nonet = sqrt(n);
-
+	layout = board.layout;
+	dim = board.dim;
+	nonet = layout->nonet;
 
 	// set possible candidates for the puzzle
-	for(int i = 1; i <= dim; i++) choices.push_back(i);
-
-	// generate candidates for each tile
-    for(int i = 0; i < dim; i++)
-	{
-        for(int j = 0; j < dim; j++)
-		{
-			matrix[i][j]->gen_candidates(choices);
-		}
-	}
-
-    // generate groups
-    for(int i = 0; i < dim; i++)
-    {
-        vector<Tile*> tmp = get_row(i);
-        groups.push_back(tmp);
-
-        tmp = get_col(i);
-        groups.push_back(tmp);
-
-        tmp = get_nonet(i);
-        groups.push_back(tmp);
-
-    }
+	choices = mask_all(dim);
+	stop = NULL;
+	budget = 0;
+	rng = NULL;
+	cache = NULL;
 }
 
 // Destructor
 Sudoku::~Sudoku()
 {
     /* do nothing */
-    /* vector will be cleaned up automatically by its destructor */
+    /* board will be cleaned up automatically by its destructor */
 }
 
 /*
@@ -64,326 +45,244 @@ Sudoku::~Sudoku()
  *          Description: Driver for a serial sudoku solver. Uses a
  *                       combination of lone_ranger() and elimination() tactics
  *                       as well as a recursive guess and check algorithm.
+ *                       With a cache, a puzzle symmetric to one solved before
+ *                       takes its solution from there, leaving only the
+ *                       values of the board up to date.
  *          Input: None
- *          Output: None
- *          Calls: propagate(), is_complete(), is_valid(), and Tile class
- *                 methods. 
+ *          Output: returns 1 if the puzzle was solved, 0 otherwise
+ *          Calls: propagate(), search(), SolveCache.lookup(),
+ *                 SolveCache.insert()
  */
 
 int Sudoku::solve()
 {
-    // apply tactics
-    int return_status;
-    propagate();
-
-    // check if our puzzle is valid
-    // if not, we return 0 and make another guess
-    if(!(is_valid(return_status)))
-        return 0;
-
-    // if complete, we return 1 and the solve()
-    // recursive stack ends
-    else if(is_complete())
+    if(cache && cache->lookup(board, symmetry, cache_key))
         return 1;
 
-    // puzzle is valid, but not solved yet
-    // start another recursive guess and check
-    else
-    {
-        // save the current state of the puzzle
-        vector<vector<int>> save = as_list();
-        vector<vector<vector<int>>> save_candidates = candidates_list();
-
-        // find the tile with the least amount of candidates
-        // recursively call solve() for each guess
-        Tile *min_tile = min_choice_tile();
-        for(unsigned int i = 0; i < min_tile->candidates.size(); i++)
-        {
-            vector<int> tmp;
-            min_tile->val = min_tile->candidates[i];
-            min_tile->candidates = tmp;
-
-            // puzzle was solved, return up the recursive stack
-            if(solve())
-                return 1;
-            // restore the state of the puzzle, make another guess
-            else
-            {
-                restore_values(save);
-                restore_candidates(save_candidates);
-            }
-        }
+    // apply tactics to the whole puzzle once
+    // if it is not valid there is nothing to guess
+    if(!propagate())
         return 0;
-    }
+    int solved = search();
+    if(solved && cache && !cache_key.empty())
+        cache->insert(board, symmetry, cache_key);
+    return solved;
 }
 
 /*
- * propagate()
- *              Description: Driver function for tactics to propagate values
- *                           into each tile in the puzzle. 
- *              Input: None
- *              Ouput: None
- *              Calls: elimination() lone_ranger()
+ *  search()
+ *          Description: Guess and check over a propagated puzzle, stopping
+ *                       at the first solution.
+ *          Input: None
+ *          Output: returns 1 if the puzzle was solved, 0 otherwise
+ *          Calls: enumerate()
  */
 
-void Sudoku::propagate()
+int Sudoku::search()
 {
-    // apply tactics until we no longer make any changes
-    int cont = 1;
-    while(cont)
-    {
-        cont = elimination();
-        lone_ranger();
-    }
+    return enumerate(1) > 0;
 }
 
 /*
- * elimination()
- *              Description: This function
- *                           checks for each group (row, column, or nonet)
- *                           the possible candidates for that group, and then
- *                           for each tile in the group, then eliminates 
- *                           candidates for that particular tile depending upon
- *                           which values are available in that group. If there
- *                           is only one available candidate left for a Tile,
- *                           then the Tile's value is set to that candidate.
- *              Input: None
- *              Output: returns 1 if a change was made, and 0 if a change was
- *                      not made to any Tile's candidates in the puzzle
- *              Calls: Tile.remove_candidates()
+ *  count()
+ *          Description: Counts the solutions of the puzzle, or stops once
+ *                       limit of them have been found. A limit of 2 is
+ *                       enough to tell whether the solution is unique.
+ *          Input: limit -> most solutions to look for, 0 for no limit
+ *          Output: number of solutions found, at most limit, or -1 if the
+ *                  budget ran out first
+ *          Calls: propagate(), enumerate()
  */
 
-int Sudoku::elimination()
+long Sudoku::count(long limit)
 {
-    // for each group in the puzzle
-	int return_value = 0;
-	for(unsigned int i = 0; i < groups.size(); i++)
-	{
-        // check which values have been used
-		set<int> used_values;
-		for(unsigned int j = 0; j < groups[i].size(); j++)
-		{
-			if(in(groups[i][j]->val, choices))
-				used_values.insert(groups[i][j]->val);
-		}
-
-        // for each tile in the group, remove_candidates()
-        // depending upon which values have been used in the group
-        for(unsigned int j = 0; j < groups[i].size(); j++)
-        {
-        	vector<int> tmp{used_values.begin(), used_values.end()};
-            int change_made = groups[i][j]->remove_candidates(tmp);
-
-            // a change was made to a Tile's candidates
-            // set return value
-            if(change_made)
-                return_value = 1;
-        }
-	}
-    return return_value;
-
+    if(!propagate())
+        return 0;
+    return enumerate(limit);
 }
 
 /*
- * lone_ranger()
- *              Description: This function
- *                           checks for each group (row, column, or nonet)
- *                           if there is an empty Tile such that one of the
- *                           candidates for that empty Tile does not appear
- *                           as one of the candidates for any other Tile in the
- *                           same group. If this is true, then it sets that 
- *                           particular candidate as the value for the Tile.
- *              Input: None
- *              Output: returns 1 if a change was made to the state of the 
- *                      puzzle, 0 otherwise.
- *              Calls: None
+ *  enumerate()
+ *          Description: Guess and check over a propagated puzzle. Instead of
+ *                       recursing and saving a copy of the board at every
+ *                       guess, keeps an explicit stack of guessed tiles and
+ *                       a trail of every change made since each guess, and
+ *                       undoes the trail back to the guess when it fails,
+ *                       or when it succeeds and more solutions are wanted.
+ *                       Counts tiles, guesses, and contradictions in stats.
+ *          Input: limit -> stop after this many solutions, 0 for no limit
+ *          Output: number of solutions found, or -1 if more than budget
+ *                  guesses were needed. If there was one, board holds
+ *                  the first, or the last one found when the limit was
+ *                  reached.
+ *          Calls: propagate(), min_choice_tile(), Trail.undo()
  */
 
-int Sudoku::lone_ranger()
+long Sudoku::enumerate(long limit)
 {
-    // for each group in the puzzle
-    int return_value = 0;
-    for(unsigned int i = 0; i < groups.size(); i++)
+    // no empty tile left, puzzle is solved
+    int min_tile = min_choice_tile();
+    if(min_tile == -1)
+        return 1;
+
+    // record every change to the board from here on
+    board.trail = &trail;
+    trail.clear();
+    frames.clear();
+
+    Frame first = {min_tile, board.cand[min_tile], trail.mark()};
+    frames.push_back(first);
+    STAT_ADD(stats, nodes, 1);
+
+    long found = 0;
+    long tries = 0;
+    int at_limit = 0;
+    Board solution;
+    while(!frames.empty())
     {
-        // check which values are available to be used for
-        // this particular group
-        set<int> leftovers{choices.begin(), choices.end()};
-        for(unsigned int j = 0; j < groups[i].size(); j++)
+        if(stop && stop->load(memory_order_relaxed))
+            break;
+
+        // roll back whatever the last guess at this tile changed
+        Frame &frame = frames.back();
+        trail.undo(board, frame.marker);
+
+        // every candidate failed, go back to the previous tile
+        if(frame.options == 0)
         {
-            if(in(groups[i][j]->val, choices))
-                leftovers.erase(groups[i][j]->val);
+            frames.pop_back();
+            continue;
         }
 
-        // for each available candidate
-        vector<int> replace{leftovers.begin(), leftovers.end()};
-        for(unsigned int j = 0; j < replace.size(); j++)
+        if(budget && ++tries > budget)
         {
-            int num_leftover = 0;
-            int place_holder;
-
-            // for each Tile in the group
-            // count how many Tile's have each available candidate
-            // in their own candidates list
-            for(unsigned int k = 0; k < groups[i].size(); k++)
-            {
-                if(in(replace[j], groups[i][k]->candidates))
-                {
-                    num_leftover++;
-                    place_holder = k;
-                }
-            }
-
-            // only one Tile has this available candidate as a
-            // candidate: then this value must be the value of the Tile 
-            if(num_leftover == 1)
-            {
-                groups[i][place_holder]->val = replace[j];
-                groups[i][place_holder]->candidates.clear();
-                return_value = 1;
-            }
+            found = -1;
+            break;
         }
-    }
-    return return_value;
-}
 
-/*
- *  in()
- *          Description: Simple helper function for elimination() and
- *                       lone_ranger(). Checks if a given value is in a vector
- *          Input: val -> particular value to check if it is in the list
- *                 list -> list to be scanned for value
- *          Output: returns 1 if the value is in the list, 0 otherwise.
- *          Calls: None
- */
-
-int Sudoku::in(int val, vector<int> list)
-{
-    // iterate through list checking if it contains
-    // the value
-	int return_value = 0;
-	for(unsigned int i = 0; i < list.size(); i++)
-	{
-		if(list[i] == val)
-		{
-			return_value = 1;
-			break;
-		}
-	}
-	return return_value;
-}
-
-/*
- * min_choice_tile()
- *                  Description: Finds the Tile in the puzzle with the least
- *                               amount of candidates.
- *                  Input: None
- *                  Output: a Tile pointer
- *                  Calls: None
- */
+        int guess;
+        if(rng)
+        {
+            // skip a random number of the candidates left
+            mask_t left = frame.options;
+            for(int k = (*rng)() % mask_count(left); k > 0; k--)
+                left &= left - 1;
+            guess = mask_lowest(left);
+            frame.options &= ~mask_bit(guess);
+        }
+        else
+        {
+            guess = mask_lowest(frame.options);
+            frame.options &= frame.options - 1;
+        }
+        STAT_ADD(stats, guesses, 1);
+        STAT_MAX(stats, max_depth, frames.size());
+        if(!propagate(frame.cell, guess))
+        {
+            STAT_ADD(stats, backtracks, 1);
+            continue;
+        }
 
-Tile* Sudoku::min_choice_tile()
-{
-    Tile *choice = NULL;
-    unsigned int min_tile_num = dim;
-    for(unsigned int i = 0; i < matrix.size(); i++)
-    {
-        for(unsigned int j = 0; j < matrix[i].size(); j++)
+        // puzzle is valid, guess at the next tile
+        // with the least amount of candidates
+        min_tile = min_choice_tile();
+        if(min_tile == -1)
         {
-            if(matrix[i][j]->val == -1)
+            found++;
+            if(limit && found >= limit)
             {
-                if(matrix[i][j]->candidates.size() < min_tile_num)
-                {
-                    choice = matrix[i][j];
-                    min_tile_num = matrix[i][j]->candidates.size();
-                }
+                at_limit = 1;
+                break;
             }
+
+            // keep the first solution and look for more
+            if(found == 1)
+                solution = board;
+            continue;
         }
+        Frame next = {min_tile, board.cand[min_tile], trail.mark()};
+        frames.push_back(next);
+        STAT_ADD(stats, nodes, 1);
     }
-    return choice;
+
+    board.trail = NULL;
+    trail.clear();
+    frames.clear();
+    if(found > 0 && !at_limit)
+        board = solution;
+    return found;
 }
 
 /*
- * as_list()
- *              Description: Saves the current state of puzzles via the current
- *                           puzzles values.
+ * propagate()
+ *              Description: Driver function for tactics to propagate values
+ *                           into each tile in the puzzle. 
  *              Input: None
- *              Output: A 2d vector of values representing the current state of
- *                      the values in the puzzle
- *              Calls: None
+ *              Ouput: returns 0 if the puzzle is no longer valid, 1 otherwise
+ *              Calls: Propagator.propagate()
  */
-vector<vector<int>> Sudoku::as_list()
+
+int Sudoku::propagate()
 {
-    vector<vector<int>> value_list(dim);
-    for(unsigned int i = 0; i < matrix.size(); i++)
-    {
-        for(unsigned int j = 0; j < matrix[i].size(); j++)
-        {
-            value_list[i].push_back(matrix[i][j]->val);
-        }
-    }
-    return value_list;
+    // apply tactics until we no longer make any changes
+    return engine.propagate(board);
 }
 
 /*
- * candidates_list()
- *                      Description: Saves the current state of the puzzles by
- *                                   storing each Tile's list of candidates.
- *                      Input: None
- *                      Output: 2d grid of the puzzles candidates
- *                      Calls: None
+ * propagate()
+ *              Description: Places a value into a tile and propagates only
+ *                           the groups affected by it.
+ *              Input: c -> cell index
+ *                     v -> value to place
+ *              Ouput: returns 0 if the puzzle is no longer valid, 1 otherwise
+ *              Calls: Propagator.propagate()
  */
 
-vector<vector<vector<int>>> Sudoku::candidates_list()
+int Sudoku::propagate(int c, int v)
 {
-    vector<vector<vector<int>>> candidates_list(dim);
-    for(unsigned int i = 0; i < matrix.size(); i++)
-    {
-        for(unsigned int j = 0; j < matrix[i].size(); j++)
-        {
-            candidates_list[i].push_back(matrix[i][j]->candidates);
-        }
-    }
-    return candidates_list;
+    return engine.propagate(board, c, v);
 }
 
 /*
- * restore_values()
- *                      Description: For a given 2d grid of values, stores the
- *                                   values back into the puzzle.
- *                      Input: Saved values for the puzzle
- *                      Output: None
- *                      Calls: None
+ * min_choice_tile()
+ *                  Description: Finds the Tile in the puzzle with the least
+ *                               amount of candidates.
+ *                  Input: None
+ *                  Output: a cell index, -1 if no empty cell was found
+ *                  Calls: min_choice_tile(const Board &)
  */
 
-void Sudoku::restore_values(vector<vector<int>> value_list)
+int Sudoku::min_choice_tile()
 {
-    for(unsigned int i = 0; i < matrix.size(); i++)
-    {
-        for(unsigned int j = 0; j < matrix[i].size(); j++)
-        {
-            matrix[i][j]->val = value_list[i][j];
-        }
-    }
+    return min_choice_tile(board);
 }
 
 /*
- * restore_values()
- *                      Description: For a given 2d grid of candidates, stores 
- *                                   the candidates back into the puzzle.
- *                      Input: Saved candidates for the puzzle
- *                      Output: None
- *                      Calls: None
+ * min_choice_tile()
+ *                  Description: Finds the Tile of any board with the least
+ *                               amount of candidates, without a Sudoku
+ *                               around it.
+ *                  Input: puzzle -> board to search
+ *                  Output: a cell index, -1 if no empty cell was found
+ *                  Calls: None
  */
 
-void Sudoku::restore_candidates(vector<vector<vector<int>>> candidate_list)
+int Sudoku::min_choice_tile(const Board &puzzle)
 {
-    for(unsigned int i = 0; i < matrix.size(); i++)
+    int choice = -1;
+    int min_tile_num = puzzle.dim + 1;
+    for(int c = 0; c < puzzle.cells; c++)
     {
-        for(unsigned int j = 0; j < matrix[i].size(); j++)
+        if(puzzle.val[c] == -1)
         {
-            matrix[i][j]->candidates = candidate_list[i][j];
+            if(mask_count(puzzle.cand[c]) < min_tile_num)
+            {
+                choice = c;
+                min_tile_num = mask_count(puzzle.cand[c]);
+            }
         }
     }
+    return choice;
 }
 
 /*
@@ -399,29 +298,17 @@ void Sudoku::print()
 	cout << "Dimension: " << dim << endl;
 	cout << "Puzzle: " << endl;
 
-	int out = (int)matrix.size();
-	for(int i = 0; i < out; i++)
+	for(int i = 0; i < dim; i++)
 	{
 		cout << "\t";
-		int in = (int)matrix[i].size();
-		for(int j = 0; j < in; j++)
+		for(int j = 0; j < dim; j++)
 		{
-			if(matrix[i][j]->val == -1)
-				cout << ".";
+			// numbers once the letters run out
+			int v = board.val[i * dim + j];
+			if(dim > TOKEN_DIM)
+				cout << setw(token_width(dim)) << (v == -1 ? 0 : v);
 			else
-			{
-				if(dim > 16)
-				{
-					int num = matrix[i][j]->val + 96;
-					printf("%c", (char)num);
-				}
-				else if(dim == 16)
-				{
-					printf("%x", matrix[i][j]->val - 1);
-				}
-				else
-					printf("%x", matrix[i][j]->val);
-			}
+				cout << encode_value(v, dim);
 			cout << " ";
 		}
 		cout << endl;
@@ -442,9 +329,9 @@ int Sudoku::is_valid(int &return_status)
 {
 	int success = 1;
 	return_status = 0;
-	for(unsigned int i = 0; i < groups.size(); i++)
+	for(int i = 0; i < layout->num_groups; i++)
 	{
-		vector<Tile*> group = groups[i];
+		const int *group = layout->group(i);
 		int stop = 0;
 
 		// check to make sure each one is valid
@@ -452,13 +339,16 @@ int Sudoku::is_valid(int &return_status)
 		{
 			for(int k = j + 1; k < dim; k++)
 			{
-				if(group[j]->val == group[k]->val && group[j]->val != -1)
+				if(board.val[group[j]] == board.val[group[k]] &&
+				   board.val[group[j]] != -1)
 				{
 					success = 0;
 					stop = (i % 3) + 1;
 					return_status = (stop * 10000) + 
-									(group[j]->row + 1) * 1000 + (group[j]->col * 100) +
-									(group[k]->row * 10) + group[k]->col;
+									(layout->row(group[j]) + 1) * 1000 +
+									(layout->col(group[j]) * 100) +
+									(layout->row(group[k]) * 10) +
+									layout->col(group[k]);
 					break;
 				}
 			}
@@ -484,82 +374,10 @@ int Sudoku::is_valid(int &return_status)
 
 int Sudoku::is_complete()
 {
-    for(int i = 0; i < dim; i++)
+    for(int c = 0; c < board.cells; c++)
     {
-        for(int j = 0; j < dim; j++)
-        {
-            if(matrix[i][j]->val == -1)
-                return 0;
-        }
+        if(board.val[c] == -1)
+            return 0;
     }
     return 1;
 }
-
-/*
- * get_row()
- *              Description: Returns a certain row from a 2d grid of vectors
- *              Input: input -> 2d grid of vectors from which to get a row
- *                     row -> index of the row to get from input
- *              Output: a row from the matrix
- *              Calls: None
- */
-vector<Tile*> Sudoku::get_row(int row)
-{
-	vector<Tile*> tmp;
-	for(int i = 0; i < dim; i++)
-	{
-		tmp.push_back(matrix[row][i]);
-	}
-	return tmp;
-
-}
-/*
- * get_col()
- *              Description: Returns a certain col from a 2d grid of vectors
- *              Input: input -> 2d grid of vectors from which to get a col
- *                     col -> index of the col to get from input
- *              Output: a col from the matrix
- *              Calls: None
- */
-
-vector<Tile*> Sudoku::get_col(int col)
-{
-	vector<Tile*> tmp;
-	for(int i = 0; i < dim; i++)
-	{
-		tmp.push_back(matrix[i][col]);
-	}
-	return tmp;
-	
-}
-
-/*
- * get_nonet()
- *              Description: Returns a certain nonet from a 2d grid of vectors.
- *                           The ordering of nonets is as follows:
- *                           0 1 2
- *                           3 4 5
- *                           6 7 8
- *              Input: input -> 2d grid of vectors from which to get a nonet
- *                     nonet -> index of the nonet to get from input
- *              Output: a nonet from the matrix
- *              Calls: None
- */
-
-vector<Tile*> Sudoku::get_nonet(int non)
-{
-	vector<Tile*> tmp;
-	int row = (non / nonet) * nonet;
-    int col = (non % nonet) * nonet;
-    int saved_col = col;
-	for(int i = 0; i < dim; i++)
-	{
-		tmp.push_back(matrix[row][col++]);
-        if((i + 1) % nonet == 0)
-        {
-            row++;
-            col = saved_col;
-        }
-	}
-	return tmp;
-}
@@ -0,0 +1,238 @@
+/*
+ * Author: Luke Vandecasteele
+ *
+ * Credits: Matthew Trappert, Dr. Jee W. Choi, Class notes, and other sources
+ *          listed in final report.
+ *
+ * Date Created: 10/17/2026
+ * Last Modified: 10/17/2026
+ *
+ * Description: Final project for CIS 431 at the University of Oregon Fall
+ *              2021. Implementation of the TaskSearch class, a parallel
+ *              sudoku solver that runs the recursive guess and check of the
+ *              serial solver as OpenMP tasks.
+ * Notes:
+ *       1. See header.h for all class methods and variables.
+ *       2. All methods contain headers for individual usage and description.
+ *       3. Every guess near the root is a task holding its own copy of the
+ *          board. Below the cutoff a task searches its subtree with the
+ *          thread's Sudoku in place, undoing guesses with the trail, so
+ *          boards are only copied where there is parallelism to gain.
+ *       4. The cutoff adapts to the team and the puzzle: tasks are made
+ *          down to a depth that gives every thread several subtrees, and
+ *          never for a board with few empty squares left.
+ *       5. The first solution cancels the taskgroup. Cancellation is only
+ *          acted on when OMP_CANCELLATION=true, so the tasks, the serial
+ *          searches, and their propagation also check a shared flag.
+ *
+ */
+
+#include "header.h"
+
+// tasks per thread the depth cutoff aims for
+#define TASKS_PER_THREAD 8
+// boards with fewer empty squares than this many rows are searched serially
+#define TASK_MIN_ROWS 2
+
+// Constructor
+TaskSearch::TaskSearch(const Board &in)
+    : board(in), stop(0), stopped_at(0), quiesce_ns(0), tasks(0)
+{
+    layout = board.layout;
+    dim = board.dim;
+    cutoff = 0;
+    min_empty = TASK_MIN_ROWS * dim;
+}
+
+// Destructor
+TaskSearch::~TaskSearch()
+{
+    for(unsigned int t = 0; t < solvers.size(); t++)
+        delete solvers[t];
+}
+
+/*
+ * solve()
+ *          Description: Propagates the puzzle once, then searches it with
+ *                       tasks, stopping at the first solution. The depth
+ *                       cutoff is the number of guesses it takes for the
+ *                       guesses at the first tile to multiply to
+ *                       TASKS_PER_THREAD subtrees per thread.
+ *          Input: None
+ *          Output: returns 1 if the puzzle was solved, 0 otherwise. The
+ *                  solution is left in board.
+ *          Calls: Propagator.propagate(), Sudoku::min_choice_tile(), expand()
+ */
+
+int TaskSearch::solve()
+{
+    {
+        ScopedTimer timer(PHASE_PROPAGATE);
+        if(!engine.propagate(board))
+            return 0;
+    }
+
+    int cell = Sudoku::min_choice_tile(board);
+    if(cell == -1)
+        return 1;
+
+    int threads = omp_get_max_threads();
+    int width = max(mask_count(board.cand[cell]), 2);
+    cutoff = 0;
+    for(long subtrees = 1; subtrees < (long)threads * TASKS_PER_THREAD &&
+                           threads > 1; subtrees *= width)
+        cutoff++;
+
+    // one solver per thread, each keeps its board and trail
+    solvers.resize(threads, NULL);
+    for(int t = 0; t < threads; t++)
+    {
+        if(solvers[t] == NULL)
+            solvers[t] = new Sudoku(board);
+        solvers[t]->stop = &stop;
+        solvers[t]->engine.stop = &stop;
+    }
+
+    stop = 0;
+    stopped_at = 0;
+    #pragma omp parallel num_threads(threads)
+    {
+        #pragma omp single
+        {
+            #pragma omp taskgroup
+            {
+                expand(board, cell, 0);
+            }
+        }
+    }
+    quiesce_ns = stop ? ReadClock() - stopped_at : 0;
+    stats.quiesce_ns = quiesce_ns;
+
+    for(int t = 0; t < threads; t++)
+    {
+        engine.merge(solvers[t]->engine);
+        stats.merge(solvers[t]->stats);
+    }
+    stats.merge(engine.stats);
+    if(stop)
+        board = first;
+    return stop.load();
+}
+
+/*
+ * expand()
+ *          Description: Makes a task for every guess at a tile. A task that
+ *                       finds a solution cancels the taskgroup.
+ *          Input: state -> board the guesses are made on, copied into
+ *                          each task
+ *                 cell -> tile to guess at
+ *                 depth -> guesses made to reach state
+ *          Output: None
+ *          Calls: guess()
+ */
+
+void TaskSearch::expand(const Board &state, int cell, int depth)
+{
+    mask_t options = state.cand[cell];
+    while(options && !stop.load(memory_order_relaxed))
+    {
+        int v = mask_lowest(options);
+        options &= options - 1;
+        tasks.fetch_add(1, memory_order_relaxed);
+
+        #pragma omp task firstprivate(state, cell, v, depth)
+        {
+            #pragma omp cancellation point taskgroup
+            if(guess(state, cell, v, depth + 1))
+            {
+                #pragma omp cancel taskgroup
+            }
+        }
+    }
+}
+
+/*
+ * guess()
+ *          Description: One task: places a guess on its copy of the board
+ *                       and propagates it with the thread's solver. Above
+ *                       the cutoff the next tile is expanded into more
+ *                       tasks, below it the rest of the subtree is searched
+ *                       in place.
+ *          Input: state -> the task's board, before the guess
+ *                 cell, v -> the guess
+ *                 depth -> guesses made, this one included
+ *          Output: returns 1 if it found a solution, 0 otherwise
+ *          Calls: Sudoku.propagate(), Sudoku.min_choice_tile(),
+ *                 Sudoku.search(), expand(), found()
+ */
+
+int TaskSearch::guess(const Board &state, int cell, int v, int depth)
+{
+    if(stop.load(memory_order_relaxed))
+        return 0;
+
+    // nothing below schedules another task on this thread
+    // until the solver's board has been copied out
+    Sudoku &puzzle = *solvers[omp_get_thread_num()];
+    puzzle.board = state;
+    STAT_ADD(puzzle.stats, guesses, 1);
+    STAT_MAX(puzzle.stats, max_depth, depth);
+    if(!puzzle.propagate(cell, v))
+    {
+        STAT_ADD(puzzle.stats, backtracks, 1);
+        return 0;
+    }
+
+    int next = puzzle.min_choice_tile();
+    if(next == -1)
+        return found(puzzle.board);
+
+    int empty = 0;
+    for(int c = 0; c < puzzle.board.cells; c++)
+        empty += puzzle.board.val[c] == -1;
+
+    if(depth < cutoff && empty >= min_empty)
+    {
+        STAT_ADD(puzzle.stats, nodes, 1);
+        Board child(puzzle.board);
+        expand(child, next, depth);
+        return 0;
+    }
+
+    if(puzzle.search())
+        return found(puzzle.board);
+    return 0;
+}
+
+/*
+ * found()
+ *          Description: Keeps the first solution and stops the serial
+ *                       searches still running. Only the thread whose
+ *                       exchange sets stop writes first and stopped_at.
+ *          Input: solution -> a solved board
+ *          Output: returns 1
+ *          Calls: None
+ */
+
+int TaskSearch::found(const Board &solution)
+{
+    if(stop.exchange(1) == 0)
+    {
+        stopped_at = ReadClock();
+        first = solution;
+    }
+    return 1;
+}
+
+/*
+ * print()
+ *          Description: Prints current state of puzzle to stdout.
+ *          Input: None
+ *          Output: None
+ *          Calls: Sudoku.print()
+ */
+
+void TaskSearch::print()
+{
+    Sudoku(board).print();
+}
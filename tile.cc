@@ -5,11 +5,11 @@
  *          listed in final report.
  *
  * Date Created: 11/8/2021
- * Last Modified: 12/2/2021
+ * Last Modified: 10/16/2026
  *
  * Description: Final project for CIS 431 at the University of Oregon Fall
- *              2021. Implementation of Tile class for storing additional
- *              information about the sqaures of the puzzle. 
+ *              2021. Implementation of Tile class for recording a value
+ *              placed into a square of the puzzle. 
  * Notes: 
  *       1. See header.h for all class methods and variables.
  *       2. All methods contain headers for individual usage and description.
@@ -48,59 +48,3 @@ void Tile::print()
 	cout << "val: }" << val;
 	cout << endl;
 }
-
-// sets the candidates of the Tile
-// called at puzzle initialization
-void Tile::gen_candidates(vector<int> choices)
-{
-	if(val == -1)
-		candidates = choices;
-}
-
-/*
- * remove_candidates()
- *											Description: Called by elimination(). For a given array
- *																	 of values that have been used in this
- *																	 Tile's group, this function removes values
- *																	 from the Tile's candidates list that can 
- *																	 no longer be used.
- *											Input: array of values that are no longer available for
- *														 the Tile's candidates.
- *											Output: returns 1 if the Tile's candidates list was
- *															made smaller, and 0 otherwise.
- *											Calls: None
- */
-
-int Tile::remove_candidates(vector<int> used_values)
-{
-	// sort lists so we can use set_difference() function
-	sort(candidates.begin(), candidates.end());
-	sort(used_values.begin(), used_values.end());
-
-	// find values that are different between the used_values in the
-	// group, and the available candidates for the Tile (i.e. check
-	// which values can still be candidates for the Tile)
-	vector<int> new_candidates(26);
-  vector<int>::iterator begin;
-	begin = set_difference(candidates.begin(), candidates.end(),
-		 						 				 used_values.begin(), used_values.end(), 
-								 				 new_candidates.begin());
-  new_candidates.resize(begin-new_candidates.begin());
-
-  // if we did not remove any candidates, return
-	if (new_candidates.size() == candidates.size())
-	{
-		return 0;
-	}
-
-	// otherwise, set our new candidates
-	// if the number of candidates is 1, then we set the value of
-	// the Tile to that leftover candidate
-	candidates = new_candidates;
-	if(candidates.size() == 1)
-	{
-		val = candidates[0];
-		candidates.pop_back();
-	}
-	return 1;
-}